@@ -0,0 +1,803 @@
+// 跳表基准测试
+//
+// 每个配置 (结构, 负载, 键分布, 规模, 线程数) 都新建一个结构并预先装入 size 个键，
+// 然后所有线程在同一时刻开始，各自执行固定数量的操作。随机数种子固定，同样的参数得到同样的操作序列。
+// 每个操作单独计时，延迟记入对数分桶的直方图（LatencyHistogram，见 stats.hpp），
+// 报告吞吐量和 p50/p99/p999。
+//
+// 键布局：预装的键是 0, 2, 4, ...（序号 i 对应键 2i），插入落在奇数键上（顺序分布时追加到末尾），
+// 因此插入的都是新键，查找、更新和删除的都是已有的键。
+//
+// 用法示例：
+//   skiplist_bench --structures=skiplist,map --workloads=lookup,a,e --dists=zipf
+//                  --sizes=1K,1M,100M --threads=1,8,64 --ops=1M
+//   skiplist_bench --report    # 节点内存占用与 finger 查找对比
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "concurrent_skiplist.hpp"
+#include "fine_grained_skiplist.hpp"
+#include "sharded_skiplist.hpp"
+#include "skiplist.hpp"
+#include "stats.hpp"
+#include "unrolled_skiplist.hpp"
+
+namespace {
+
+using Key = std::uint64_t;
+using Value = std::uint64_t;
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// 基线：标准库容器加一把读写锁，与 SkipList 的加锁方式相同
+// ---------------------------------------------------------------------------
+
+template <typename Map>
+class LockedMap {
+	mutable std::shared_mutex mutex;
+	Map map;
+
+public:
+	// std::unordered_map 没有顺序，不参加范围扫描
+	static constexpr bool kOrdered = !std::is_same_v<Map, std::unordered_map<Key, Value>>;
+
+	bool insert(const Key& key, const Value& value) {
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		return map.emplace(key, value).second;
+	}
+
+	bool insert_or_assign(const Key& key, const Value& value) {
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		return map.insert_or_assign(key, value).second;
+	}
+
+	bool remove(const Key& key) {
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		return map.erase(key) == 1;
+	}
+
+	std::optional<Value> search(const Key& key) const {
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		auto it = map.find(key);
+		if (it == map.end()) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+	template <typename Callback>
+	std::size_t scan(const Key& lo, const Key& hi, Callback&& callback) const {
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		std::size_t visited = 0;
+		if constexpr (kOrdered) {
+			for (auto it = map.lower_bound(lo); it != map.end() && it->first < hi; ++it) {
+				callback(it->first, it->second);
+				visited++;
+			}
+		}
+		return visited;
+	}
+};
+
+template <typename T>
+struct IsOrdered : std::true_type {};
+
+template <typename Map>
+struct IsOrdered<LockedMap<Map>> : std::bool_constant<LockedMap<Map>::kOrdered> {};
+
+template <typename T, typename = void>
+struct HasInsertOrAssign : std::false_type {};
+
+template <typename T>
+struct HasInsertOrAssign<T, std::void_t<decltype(std::declval<T&>().insert_or_assign(
+								std::declval<const Key&>(), std::declval<const Value&>()))>>
+	: std::true_type {};
+
+template <typename T, typename = void>
+struct HasMultiGet : std::false_type {};
+
+template <typename T>
+struct HasMultiGet<T, std::void_t<decltype(std::declval<const T&>().multiGet(
+						  std::declval<const std::vector<Key>&>()))>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasMultiPut : std::false_type {};
+
+template <typename T>
+struct HasMultiPut<T, std::void_t<decltype(std::declval<T&>().multiPut(
+						  std::declval<const std::vector<std::pair<Key, Value>>&>()))>>
+	: std::true_type {};
+
+// 更新已有的键。ConcurrentSkipList 和 FineGrainedSkipList 没有 insert_or_assign，
+// 用 remove + insert 代替（两步之间键短暂不可见，基准测试中可以接受）
+template <typename Structure>
+void update(Structure& structure, const Key& key, const Value& value) {
+	if constexpr (HasInsertOrAssign<Structure>::value) {
+		structure.insert_or_assign(key, value);
+	} else {
+		structure.remove(key);
+		structure.insert(key, value);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// 键分布
+// ---------------------------------------------------------------------------
+
+enum class Distribution { Uniform, Zipf, Sequential };
+
+// 64 位的可逆混淆（MurmurHash3 的 fmix64），把 Zipf 的热点排名打散到整个键空间
+Key scramble(Key x) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+// YCSB 的 Zipf 生成器（Gray 等人的方法），theta = 0.99 时排名 0 最热。
+// zeta(n) 只在构造时计算一次，各线程共享，next() 只读
+class ZipfGenerator {
+	Key n;
+	double theta;
+	double alpha;
+	double zetan;
+	double eta;
+
+	static double zeta(Key n, double theta) {
+		double sum = 0;
+		for (Key i = 1; i <= n; i++) {
+			sum += 1.0 / std::pow(static_cast<double>(i), theta);
+		}
+		return sum;
+	}
+
+public:
+	explicit ZipfGenerator(Key count, double th = 0.99)
+		: n(std::max<Key>(count, 2)), theta(th), alpha(1.0 / (1.0 - th)), zetan(zeta(n, th)) {
+		double zeta2 = zeta(2, theta);
+		eta = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+	}
+
+	template <typename Rng>
+	Key next(Rng& rng) const {
+		double u = std::uniform_real_distribution<>(0.0, 1.0)(rng);
+		double uz = u * zetan;
+		if (uz < 1.0) {
+			return 0;
+		}
+		if (uz < 1.0 + std::pow(0.5, theta)) {
+			return 1;
+		}
+		auto rank = static_cast<Key>(n * std::pow(eta * u - eta + 1.0, alpha));
+		return std::min(rank, n - 1);
+	}
+};
+
+// 每个线程一个：在 [0, n) 中按分布产生序号。
+// 顺序分布下每个线程从自己那一段的起点开始依次递增，到末尾后回绕
+class KeyChooser {
+	Distribution distribution;
+	Key n;
+	const ZipfGenerator* zipf;
+	std::mt19937_64 rng;
+	Key cursor;
+
+public:
+	KeyChooser(Distribution dist, Key count, const ZipfGenerator* z, int thread, int threads,
+			   unsigned seed)
+		: distribution(dist), n(std::max<Key>(count, 1)), zipf(z),
+		  rng(seed * 1000003ULL + static_cast<unsigned>(thread)),
+		  cursor(n / static_cast<Key>(threads) * static_cast<Key>(thread)) {}
+
+	Key next() {
+		switch (distribution) {
+		case Distribution::Uniform:
+			return rng() % n;
+		case Distribution::Zipf:
+			return scramble(zipf->next(rng)) % n;
+		case Distribution::Sequential:
+			break;
+		}
+		Key index = cursor;
+		cursor = cursor + 1 == n ? 0 : cursor + 1;
+		return index;
+	}
+
+	// 与键无关的随机数：选择操作类型、扫描长度
+	std::uint64_t random() {
+		return rng();
+	}
+};
+
+using skiplist::LatencyHistogram;
+
+// ---------------------------------------------------------------------------
+// 负载
+// ---------------------------------------------------------------------------
+
+enum class Workload {
+	Lookup,
+	Insert,
+	Remove,
+	Scan,
+	YcsbA,
+	YcsbB,
+	YcsbC,
+	YcsbE,
+	MultiGet,
+	MultiPut
+};
+
+bool is_batched(Workload workload) {
+	return workload == Workload::MultiGet || workload == Workload::MultiPut;
+}
+
+bool needs_scan(Workload workload) {
+	return workload == Workload::Scan || workload == Workload::YcsbE;
+}
+
+struct Config {
+	std::vector<std::string> structures = {"skiplist", "map"};
+	std::vector<Workload> workloads = {Workload::Lookup, Workload::Insert, Workload::Remove,
+									   Workload::Scan,	 Workload::YcsbA,  Workload::YcsbB,
+									   Workload::YcsbC,	 Workload::YcsbE,  Workload::MultiGet,
+									   Workload::MultiPut};
+	std::vector<Distribution> distributions = {Distribution::Uniform};
+	std::vector<Key> sizes = {100000};
+	std::vector<int> threads = {1};
+	Key ops = 100000;	// 每个线程的操作数
+	int scanLength = 100; // 范围扫描访问的键数（YCSB E 在 [1, scanLength] 中均匀选取）
+	int batchSize = 16;	  // multiget/multiput 每批的键数
+	unsigned seed = 42;
+	bool report = false;
+};
+
+struct Result {
+	double seconds = 0;
+	std::uint64_t operations = 0;
+	LatencyHistogram latency;
+};
+
+
+// 单个线程的操作循环。checksum 累加读到的结果，防止查找被优化掉
+template <typename Structure>
+void run_thread(Structure& structure, Workload workload, Distribution distribution,
+				KeyChooser& chooser, Key size, const Config& config, int thread, int threads,
+				LatencyHistogram& latency, std::uint64_t& checksum) {
+	// 顺序分布下插入追加到末尾（各线程交错取号），删除从本线程那一段的起点依次删除
+	Key appended = static_cast<Key>(thread);
+	auto existing = [&chooser] { return 2 * chooser.next(); };
+	auto fresh = [&]() -> Key {
+		if (distribution != Distribution::Sequential) {
+			return 2 * chooser.next() + 1;
+		}
+		Key key = 2 * (size + appended);
+		appended += static_cast<Key>(threads);
+		return key;
+	};
+	auto scan = [&](Key length) {
+		Key lo = existing();
+		structure.scan(lo, lo + 2 * length,
+					   [&checksum](const Key& key, const Value&) { checksum += key; });
+	};
+	std::vector<Key> batch;
+	std::vector<std::pair<Key, Value>> entries;
+	const std::uint64_t updatePercent = workload == Workload::YcsbA   ? 50
+										: workload == Workload::YcsbB ? 5
+																	  : 0;
+
+	for (Key i = 0; i < config.ops; i++) {
+		auto start = Clock::now();
+		switch (workload) {
+		case Workload::Lookup:
+			checksum += structure.search(existing()).value_or(0);
+			break;
+		case Workload::Insert:
+			checksum += structure.insert(fresh(), i);
+			break;
+		case Workload::Remove:
+			checksum += structure.remove(existing());
+			break;
+		case Workload::Scan:
+			scan(static_cast<Key>(config.scanLength));
+			break;
+		case Workload::YcsbA:
+		case Workload::YcsbB:
+		case Workload::YcsbC:
+			if (chooser.random() % 100 < updatePercent) {
+				update(structure, existing(), i);
+			} else {
+				checksum += structure.search(existing()).value_or(0);
+			}
+			break;
+		case Workload::YcsbE:
+			if (chooser.random() % 100 < 5) {
+				structure.insert(fresh(), i);
+			} else {
+				scan(chooser.random() % static_cast<Key>(config.scanLength) + 1);
+			}
+			break;
+		case Workload::MultiGet:
+			if constexpr (HasMultiGet<Structure>::value) {
+				batch.clear();
+				for (int b = 0; b < config.batchSize; b++) {
+					batch.push_back(existing());
+				}
+				for (const auto& value : structure.multiGet(batch)) {
+					checksum += value.value_or(0);
+				}
+			}
+			break;
+		case Workload::MultiPut:
+			if constexpr (HasMultiPut<Structure>::value) {
+				entries.clear();
+				for (int b = 0; b < config.batchSize; b++) {
+					entries.emplace_back(fresh(), i);
+				}
+				for (bool inserted : structure.multiPut(entries)) {
+					checksum += inserted;
+				}
+			}
+			break;
+		}
+		latency.record(static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+	}
+}
+
+// 运行一个配置：预装 size 个键后所有线程同时开始，墙钟时间从放行到最后一个线程结束
+template <typename Structure>
+Result run_config(Structure& structure, Workload workload, Distribution distribution, Key size,
+				  int threads, const Config& config, const ZipfGenerator* zipf) {
+	for (Key i = 0; i < size; i++) {
+		structure.insert(2 * i, i);
+	}
+
+	std::vector<LatencyHistogram> latencies(threads);
+	std::vector<std::uint64_t> checksums(threads, 0);
+	std::atomic<int> ready{0};
+	std::atomic<bool> go{false};
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			KeyChooser chooser(distribution, size, zipf, t, threads, config.seed);
+			ready.fetch_add(1);
+			while (!go.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+			run_thread(structure, workload, distribution, chooser, size, config, t, threads,
+					   latencies[t], checksums[t]);
+		});
+	}
+	while (ready.load() != threads) {
+		std::this_thread::yield();
+	}
+	auto start = Clock::now();
+	go.store(true, std::memory_order_release);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	Result result;
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	// multiget/multiput 按键数计算吞吐量，延迟则是整批的耗时
+	result.operations = config.ops * static_cast<Key>(threads);
+	if (is_batched(workload)) {
+		result.operations *= static_cast<Key>(config.batchSize);
+	}
+	for (const auto& latency : latencies) {
+		result.latency.merge(latency);
+	}
+	volatile std::uint64_t sink = 0;
+	for (std::uint64_t checksum : checksums) {
+		sink = sink + checksum;
+	}
+	return result;
+}
+
+const char* workload_name(Workload workload) {
+	switch (workload) {
+	case Workload::Lookup:
+		return "lookup";
+	case Workload::Insert:
+		return "insert";
+	case Workload::Remove:
+		return "remove";
+	case Workload::Scan:
+		return "scan";
+	case Workload::YcsbA:
+		return "ycsb-a";
+	case Workload::YcsbB:
+		return "ycsb-b";
+	case Workload::YcsbC:
+		return "ycsb-c";
+	case Workload::YcsbE:
+		return "ycsb-e";
+	case Workload::MultiGet:
+		return "multiget";
+	case Workload::MultiPut:
+		return "multiput";
+	}
+	return "?";
+}
+
+const char* distribution_name(Distribution distribution) {
+	switch (distribution) {
+	case Distribution::Uniform:
+		return "uniform";
+	case Distribution::Zipf:
+		return "zipf";
+	case Distribution::Sequential:
+		return "sequential";
+	}
+	return "?";
+}
+
+void print_header() {
+	std::cout << std::left << std::setw(14) << "structure" << std::setw(9) << "workload"
+			  << std::setw(11) << "dist" << std::right << std::setw(11) << "size" << std::setw(5)
+			  << "thr" << std::setw(11) << "Mops/s" << std::setw(10) << "p50(ns)" << std::setw(10)
+			  << "p99(ns)" << std::setw(10) << "p999(ns)" << std::endl;
+}
+
+void print_result(const std::string& structure, Workload workload, Distribution distribution,
+				  Key size, int threads, const Result& result) {
+	std::cout << std::left << std::setw(14) << structure << std::setw(9)
+			  << workload_name(workload) << std::setw(11) << distribution_name(distribution)
+			  << std::right << std::setw(11) << size << std::setw(5) << threads << std::fixed
+			  << std::setprecision(3) << std::setw(11)
+			  << result.operations / result.seconds / 1e6 << std::setprecision(0)
+			  << std::setw(10) << result.latency.percentile(0.50) << std::setw(10)
+			  << result.latency.percentile(0.99) << std::setw(10)
+			  << result.latency.percentile(0.999) << std::defaultfloat << std::endl;
+}
+
+// 对一种结构跑完全部 (负载, 分布, 规模, 线程数) 组合，每个组合使用新建的结构
+template <typename Structure>
+void run_structure(const std::string& name, const Config& config,
+				   const std::function<std::unique_ptr<Structure>()>& make) {
+	for (Key size : config.sizes) {
+		for (Distribution distribution : config.distributions) {
+			std::unique_ptr<ZipfGenerator> zipf;
+			if (distribution == Distribution::Zipf) {
+				zipf = std::make_unique<ZipfGenerator>(size);
+			}
+			for (Workload workload : config.workloads) {
+				if (needs_scan(workload) && !IsOrdered<Structure>::value) {
+					continue;
+				}
+				if ((workload == Workload::MultiGet && !HasMultiGet<Structure>::value) ||
+					(workload == Workload::MultiPut && !HasMultiPut<Structure>::value)) {
+					continue;
+				}
+				for (int threads : config.threads) {
+					auto structure = make();
+					Result result = run_config(*structure, workload, distribution, size, threads,
+											   config, zipf.get());
+					print_result(name, workload, distribution, size, threads, result);
+				}
+			}
+		}
+	}
+}
+
+bool run_named(const std::string& name, const Config& config) {
+	if (name == "skiplist") {
+		using List = skiplist::SkipList<Key, Value>;
+		run_structure<List>(name, config, [] { return std::make_unique<List>(); });
+	} else if (name == "unrolled") {
+		using List = skiplist::UnrolledSkipList<Key, Value>;
+		run_structure<List>(name, config, [] { return std::make_unique<List>(); });
+	} else if (name == "concurrent") {
+		using List = skiplist::ConcurrentSkipList<Key, Value>;
+		run_structure<List>(name, config, [] { return std::make_unique<List>(); });
+	} else if (name == "fine_grained") {
+		using List = skiplist::FineGrainedSkipList<Key, Value>;
+		run_structure<List>(name, config, [] { return std::make_unique<List>(); });
+	} else if (name == "sharded") {
+		using List = skiplist::ShardedSkipList<Key, Value>;
+		run_structure<List>(name, config, [] { return std::make_unique<List>(); });
+	} else if (name == "map") {
+		using Map = LockedMap<std::map<Key, Value>>;
+		run_structure<Map>(name, config, [] { return std::make_unique<Map>(); });
+	} else if (name == "unordered_map") {
+		using Map = LockedMap<std::unordered_map<Key, Value>>;
+		run_structure<Map>(name, config, [] { return std::make_unique<Map>(); });
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// 附加报告：节点内存占用与 finger 查找
+// ---------------------------------------------------------------------------
+
+// 旧版节点布局：forward 存放在 std::vector 中，需要额外一次堆分配
+struct VectorTowerNode {
+	int key;
+	std::string value;
+	std::vector<void*> forward;
+};
+
+// 每节点内存占用对比（按 p = 0.5 时的平均层数估算）
+void node_memory_report(int max_level) {
+	std::cout << "\n=== 节点内存占用 (K=int, V=std::string) ===" << std::endl;
+
+	double expected_pointers = 0; // 平均每个节点的 forward 指针数 = E[level + 1]
+	double probability = 1.0;
+	for (int level = 0; level <= max_level; level++) {
+		double p_level = (level == max_level) ? probability : probability * 0.5;
+		expected_pointers += p_level * (level + 1);
+		probability -= p_level;
+	}
+
+	using StringNode = skiplist::Node<int, std::string>;
+	double vector_bytes = sizeof(VectorTowerNode) + expected_pointers * sizeof(void*);
+	// 每多一层增加一个指针（整数键还有一个缓存的后继键）
+	double per_level = StringNode::allocationSize(1) - StringNode::allocationSize(0);
+	double inline_bytes = StringNode::allocationSize(0) + (expected_pointers - 1) * per_level;
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "平均 forward 指针数: " << expected_pointers << std::endl;
+	std::cout << "vector 塔: " << vector_bytes << " 字节/节点, 2 次分配/插入" << std::endl;
+	std::cout << "内联塔:   " << inline_bytes << " 字节/节点, 1 次分配/插入" << std::endl;
+	std::cout << std::defaultfloat;
+}
+
+// 普通查找与 finger 查找在同一个键流上的耗时对比（单线程）
+void finger_search_benchmark(const std::string& name, const skiplist::SkipList<Key, Value>& sl,
+							 const std::vector<Key>& keys) {
+	std::uint64_t found = 0;
+	auto start = Clock::now();
+	for (Key key : keys) {
+		found += sl.search(key).has_value();
+	}
+	auto plain = Clock::now() - start;
+
+	skiplist::SkipList<Key, Value>::Finger finger;
+	start = Clock::now();
+	for (Key key : keys) {
+		found += sl.search(key, finger).has_value();
+	}
+	auto fingered = Clock::now() - start;
+
+	auto ns_per_op = [&keys](Clock::duration elapsed) {
+		return std::chrono::duration<double, std::nano>(elapsed).count() / keys.size();
+	};
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << name << ": search " << ns_per_op(plain) << " ns/op, finger "
+			  << ns_per_op(fingered) << " ns/op (命中 " << found / 2 << ")" << std::endl;
+	std::cout << std::defaultfloat;
+}
+
+void finger_search_report(unsigned seed) {
+	std::cout << "\n=== finger 查找 (1M 个键) ===" << std::endl;
+	const Key num_keys = 1 << 20;
+	const Key num_lookups = 1 << 20;
+
+	skiplist::SkipList<Key, Value> sl(20);
+	std::vector<std::pair<Key, Value>> sorted;
+	sorted.reserve(num_keys);
+	for (Key i = 0; i < num_keys; i++) {
+		sorted.emplace_back(i, i);
+	}
+	sl.bulkLoad(sorted.begin(), sorted.end());
+
+	// Zipf 的热点不打散，集中在键空间的开头，连续的查找彼此靠近
+	std::vector<Key> sequential(num_lookups);
+	std::vector<Key> zipf(num_lookups);
+	std::vector<Key> uniform(num_lookups);
+	ZipfGenerator generator(num_keys);
+	std::mt19937_64 rng(seed);
+	for (Key i = 0; i < num_lookups; i++) {
+		sequential[i] = i;
+		zipf[i] = generator.next(rng);
+		uniform[i] = rng() % num_keys;
+	}
+	finger_search_benchmark("顺序", sl, sequential);
+	finger_search_benchmark("Zipf(0.99)", sl, zipf);
+	finger_search_benchmark("均匀随机", sl, uniform);
+}
+
+// ---------------------------------------------------------------------------
+// 命令行
+// ---------------------------------------------------------------------------
+
+std::vector<std::string> split(const std::string& list) {
+	std::vector<std::string> items;
+	std::stringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ',')) {
+		if (!item.empty()) {
+			items.push_back(item);
+		}
+	}
+	return items;
+}
+
+// 数量支持 K/M/G 后缀（1000 进制），例如 100M
+std::optional<Key> parse_count(const std::string& text) {
+	char* end = nullptr;
+	unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+	if (end == text.c_str()) {
+		return std::nullopt;
+	}
+	std::string suffix(end);
+	if (suffix == "K" || suffix == "k") {
+		value *= 1000;
+	} else if (suffix == "M" || suffix == "m") {
+		value *= 1000 * 1000;
+	} else if (suffix == "G" || suffix == "g") {
+		value *= 1000 * 1000 * 1000;
+	} else if (!suffix.empty()) {
+		return std::nullopt;
+	}
+	return static_cast<Key>(value);
+}
+
+std::optional<Workload> parse_workload(const std::string& name) {
+	const Workload all[] = {Workload::Lookup, Workload::Insert, Workload::Remove,
+							Workload::Scan,	  Workload::YcsbA,	Workload::YcsbB,
+							Workload::YcsbC,  Workload::YcsbE,	Workload::MultiGet,
+							Workload::MultiPut};
+	for (Workload workload : all) {
+		std::string full = workload_name(workload);
+		if (name == full || "ycsb-" + name == full) {
+			return workload;
+		}
+	}
+	return std::nullopt;
+}
+
+std::optional<Distribution> parse_distribution(const std::string& name) {
+	for (Distribution distribution :
+		 {Distribution::Uniform, Distribution::Zipf, Distribution::Sequential}) {
+		if (name == distribution_name(distribution)) {
+			return distribution;
+		}
+	}
+	return std::nullopt;
+}
+
+void usage() {
+	std::cout
+		<< "用法: skiplist_bench [选项]\n"
+		<< "  --structures=LIST  skiplist,unrolled,concurrent,fine_grained,sharded,\n"
+		<< "                     map,unordered_map（标准库容器加读写锁，作为基线）\n"
+		<< "  --workloads=LIST   lookup,insert,remove,scan,a,b,c,e（YCSB A/B/C/E），\n"
+		<< "                     multiget,multiput（只对提供 multiGet/multiPut 的 skiplist）\n"
+		<< "  --dists=LIST       uniform,zipf,sequential\n"
+		<< "  --sizes=LIST       预装的键数，例如 1K,1M,100M\n"
+		<< "  --threads=LIST     线程数，例如 1,4,16,64\n"
+		<< "  --ops=N            每个线程的操作数\n"
+		<< "  --scan-length=N    范围扫描的键数\n"
+		<< "  --batch=N          multiget/multiput 每批的键数\n"
+		<< "  --seed=N           随机数种子\n"
+		<< "  --report           输出节点内存占用与 finger 查找对比后退出\n";
+}
+
+// 解析失败时打印原因并返回 std::nullopt
+std::optional<Config> parse_args(int argc, char** argv) {
+	Config config;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--report") {
+			config.report = true;
+			continue;
+		}
+		auto equals = arg.find('=');
+		if (arg.rfind("--", 0) != 0 || equals == std::string::npos) {
+			std::cerr << "无法识别的参数: " << arg << std::endl;
+			return std::nullopt;
+		}
+		std::string option = arg.substr(2, equals - 2);
+		std::vector<std::string> values = split(arg.substr(equals + 1));
+		bool ok = !values.empty();
+
+		if (option == "structures") {
+			config.structures = values;
+		} else if (option == "workloads") {
+			config.workloads.clear();
+			for (const auto& value : values) {
+				auto workload = parse_workload(value);
+				ok = ok && workload;
+				config.workloads.push_back(workload.value_or(Workload::Lookup));
+			}
+		} else if (option == "dists") {
+			config.distributions.clear();
+			for (const auto& value : values) {
+				auto distribution = parse_distribution(value);
+				ok = ok && distribution;
+				config.distributions.push_back(distribution.value_or(Distribution::Uniform));
+			}
+		} else if (option == "sizes" || option == "threads") {
+			std::vector<Key> counts;
+			for (const auto& value : values) {
+				auto count = parse_count(value);
+				ok = ok && count && *count > 0;
+				counts.push_back(count.value_or(1));
+			}
+			if (option == "sizes") {
+				config.sizes = counts;
+			} else {
+				config.threads.assign(counts.begin(), counts.end());
+			}
+		} else if (option == "ops" || option == "scan-length" || option == "batch" ||
+				   option == "seed") {
+			auto count = ok && values.size() == 1 ? parse_count(values[0]) : std::nullopt;
+			ok = count.has_value();
+			if (option == "ops") {
+				config.ops = count.value_or(0);
+			} else if (option == "scan-length") {
+				ok = ok && *count > 0;
+				config.scanLength = static_cast<int>(count.value_or(1));
+			} else if (option == "batch") {
+				ok = ok && *count > 0;
+				config.batchSize = static_cast<int>(count.value_or(1));
+			} else {
+				config.seed = static_cast<unsigned>(count.value_or(0));
+			}
+		} else {
+			ok = false;
+		}
+
+		if (!ok) {
+			std::cerr << "无效的参数: " << arg << std::endl;
+			return std::nullopt;
+		}
+	}
+	return config;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+		usage();
+		return 0;
+	}
+	std::optional<Config> config = parse_args(argc, argv);
+	if (!config) {
+		usage();
+		return 1;
+	}
+
+	if (config->report) {
+		node_memory_report(16);
+		finger_search_report(config->seed);
+		return 0;
+	}
+
+	print_header();
+	for (const auto& name : config->structures) {
+		if (!run_named(name, *config)) {
+			std::cerr << "未知的结构: " << name << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -61,13 +61,21 @@ int main() {
 
 	// 搜索测试
 	std::cout << "\n--- Search test ---" << std::endl;
-	sl.search(19);
-	sl.search(15); // 不存在的key
+	for (int key : {19, 15}) { // 15 是不存在的key
+		auto value = sl.search(key);
+		if (value) {
+			std::cout << "Found key " << key << ", value: " << *value << std::endl;
+		} else {
+			std::cout << "Key " << key << " not found." << std::endl;
+		}
+	}
 
 	// 删除测试
 	std::cout << "\n--- Delete test ---" << std::endl;
-	sl.remove(19);
-	sl.remove(15); // 不存在的key
+	for (int key : {19, 15}) {
+		std::cout << "remove(" << key << "): " << (sl.remove(key) ? "deleted" : "not found")
+				  << std::endl;
+	}
 
 	// 显示删除后的结构
 	std::cout << "\n--- After deletion ---" << std::endl;
@@ -0,0 +1,180 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace skiplist {
+
+// 节点分配器接口（SkipList 的 Alloc 模板参数）：
+//
+//   void* allocate(std::size_t bytes, int level);
+//   void deallocate(void* pointer, std::size_t bytes, int level);
+//   static constexpr bool kBulkRelease;  // 可选，为 true 表示析构时统一归还全部内存
+//
+// level 是节点高度，同一个跳表中相同高度的节点大小相同，分配器可以据此按高度分级管理。
+// 分配器的调用总是发生在跳表的写锁内，分配器本身不需要线程安全。
+
+// 默认分配器：直接使用全局 operator new/delete
+class NewDeleteAllocator {
+public:
+	static constexpr bool kBulkRelease = false;
+
+	void* allocate(std::size_t bytes, int /*level*/) {
+		return ::operator new(bytes);
+	}
+
+	void deallocate(void* pointer, std::size_t /*bytes*/, int /*level*/) {
+		::operator delete(pointer);
+	}
+};
+
+// 按节点高度分级的 arena：每个高度有自己的 slab 链和空闲链表，
+// 分配优先复用空闲块，否则在当前 slab 上移动指针（bump pointer）；
+// 释放只是把块挂回空闲链表，所有 slab 在 arena 析构时一次性归还。
+class ArenaAllocator {
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct SizeClass {
+		std::size_t blockSize = 0;
+		std::size_t nextSlabBlocks = kInitialSlabBlocks;
+		FreeBlock* freeList = nullptr;
+		char* cursor = nullptr;
+		char* limit = nullptr;
+	};
+
+	// 高层节点很少，slab 从少量块开始按倍数增长，避免每个高度都预占一大块内存
+	static constexpr std::size_t kInitialSlabBlocks = 8;
+	static constexpr std::size_t kAlignment = alignof(std::max_align_t);
+
+	std::size_t maxSlabBytes;
+	std::vector<SizeClass> classes;
+	std::vector<void*> slabs;
+	std::size_t reservedBytes;
+
+	void refill(SizeClass& sizeClass);
+
+	void releaseAll();
+
+public:
+	static constexpr bool kBulkRelease = true;
+	static constexpr std::size_t kDefaultSlabBytes = 64 * 1024;
+
+	explicit ArenaAllocator(std::size_t slabBytes = kDefaultSlabBytes)
+		: maxSlabBytes(slabBytes), reservedBytes(0) {}
+
+	~ArenaAllocator() {
+		releaseAll();
+	}
+
+	ArenaAllocator(const ArenaAllocator&) = delete;
+	ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+	ArenaAllocator(ArenaAllocator&& other) noexcept
+		: maxSlabBytes(other.maxSlabBytes), classes(std::move(other.classes)),
+		  slabs(std::move(other.slabs)), reservedBytes(other.reservedBytes) {
+		other.classes.clear();
+		other.slabs.clear();
+		other.reservedBytes = 0;
+	}
+
+	ArenaAllocator& operator=(ArenaAllocator&& other) noexcept {
+		if (this != &other) {
+			releaseAll();
+			maxSlabBytes = other.maxSlabBytes;
+			classes = std::move(other.classes);
+			slabs = std::move(other.slabs);
+			reservedBytes = other.reservedBytes;
+			other.classes.clear();
+			other.slabs.clear();
+			other.reservedBytes = 0;
+		}
+		return *this;
+	}
+
+	void* allocate(std::size_t bytes, int level);
+
+	void deallocate(void* pointer, std::size_t bytes, int level);
+
+	// 已向系统申请的 slab 总字节数
+	std::size_t bytesReserved() const {
+		return reservedBytes;
+	}
+};
+
+inline void ArenaAllocator::refill(SizeClass& sizeClass) {
+	std::size_t slabBytes = std::min(maxSlabBytes, sizeClass.nextSlabBlocks * sizeClass.blockSize);
+	slabBytes = std::max(slabBytes, sizeClass.blockSize);
+	char* slab = static_cast<char*>(::operator new(slabBytes));
+	slabs.push_back(slab);
+	reservedBytes += slabBytes;
+
+	sizeClass.cursor = slab;
+	sizeClass.limit = slab + slabBytes;
+	sizeClass.nextSlabBlocks *= 2;
+}
+
+inline void* ArenaAllocator::allocate(std::size_t bytes, int level) {
+	if (static_cast<std::size_t>(level) >= classes.size()) {
+		classes.resize(level + 1);
+	}
+	SizeClass& sizeClass = classes[level];
+	if (sizeClass.blockSize == 0) {
+		std::size_t size = std::max(bytes, sizeof(FreeBlock));
+		sizeClass.blockSize = (size + kAlignment - 1) / kAlignment * kAlignment;
+	}
+	assert(bytes <= sizeClass.blockSize);
+
+	if (sizeClass.freeList != nullptr) {
+		FreeBlock* block = sizeClass.freeList;
+		sizeClass.freeList = block->next;
+		return block;
+	}
+
+	if (sizeClass.cursor == nullptr ||
+		static_cast<std::size_t>(sizeClass.limit - sizeClass.cursor) < sizeClass.blockSize) {
+		refill(sizeClass);
+	}
+	void* block = sizeClass.cursor;
+	sizeClass.cursor += sizeClass.blockSize;
+	return block;
+}
+
+inline void ArenaAllocator::deallocate(void* pointer, std::size_t /*bytes*/, int level) {
+	SizeClass& sizeClass = classes[level];
+	FreeBlock* block = static_cast<FreeBlock*>(pointer);
+	block->next = sizeClass.freeList;
+	sizeClass.freeList = block;
+}
+
+inline void ArenaAllocator::releaseAll() {
+	for (void* slab : slabs) {
+		::operator delete(slab);
+	}
+	slabs.clear();
+	classes.clear();
+	reservedBytes = 0;
+}
+
+namespace detail {
+
+template <typename Alloc, typename = void>
+struct AllocatorBulkRelease : std::false_type {};
+
+template <typename Alloc>
+struct AllocatorBulkRelease<Alloc, std::void_t<decltype(Alloc::kBulkRelease)>>
+	: std::integral_constant<bool, Alloc::kBulkRelease> {};
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // ALLOCATOR_HPP
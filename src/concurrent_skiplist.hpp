@@ -0,0 +1,430 @@
+#ifndef CONCURRENT_SKIPLIST_HPP
+#define CONCURRENT_SKIPLIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "detail.hpp"
+#include "epoch.hpp"
+#include "level_generator.hpp"
+#include "node.hpp"
+
+namespace skiplist {
+
+// 无锁跳表（Harris / Fraser 风格，参考 Herlihy & Shavit 的 LockFreeSkipList）
+//
+// - 所有 forward 链接都是原子的带标记指针，insert/remove 通过 CAS 修改
+// - remove 先自顶向下标记被删节点的各层链接（逻辑删除），标记第 0 层成功即为线性化点，
+//   之后由 find() 在遍历时顺手把被标记节点从各层摘除（物理删除）
+// - search 不做任何写操作，也不会重试，是 wait-free 的
+//
+// 每个操作都在 EpochManager 的临界区内进行，被摘除的节点交给纪元回收延迟释放，
+// 读者无需加锁即可安全遍历；通过 pin() + lookup() 还可以在临界区内直接持有值的指针。
+// MaxLevel 的含义与 SkipList 相同：编译期层数上限，preds/succs 数组放在栈上
+template <typename K, typename V, int MaxLevel = 32>
+class ConcurrentSkipList {
+	static_assert(MaxLevel >= 0, "MaxLevel must be non-negative");
+
+private:
+	using NodeType = ConcurrentNode<K, V>;
+	using NodeArray = std::array<NodeType*, MaxLevel + 1>;
+
+	int maxLevel;
+	float p;
+	detail::LevelGenerator levelGenerator;
+	std::atomic<int> currentLevel; // 只增不减，避免与并发插入的高层节点产生竞争
+	NodeType* header;
+	mutable EpochManager epochs;
+	// 在插入/删除的线性化点之后增减，没有进行中的操作时是精确值
+	std::atomic<int> elementCount;
+	std::atomic<int> heightCounts[MaxLevel + 1];
+
+	bool find(const K& key, NodeType** preds, NodeType** succs);
+
+	void raiseCurrentLevel(int level);
+
+	void retire(NodeType* node);
+
+	// 只读下降，返回第一个键 >= key 且未被删除的节点
+	NodeType* findGreaterOrEqual(const K& key) const;
+
+	// 第 0 层上 node 之后第一个未被删除的节点
+	static NodeType* nextUnmarked(NodeType* node);
+
+public:
+	using Guard = EpochManager::Guard;
+
+	explicit ConcurrentSkipList(int maxLvl = MaxLevel, float prob = 0.5);
+	~ConcurrentSkipList();
+
+	ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+	ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+	int getRandomLevel();
+
+	// 插入成功返回 true，键已存在返回 false
+	bool insert(const K& key, const V& value);
+
+	// 本线程成功删除该键时返回 true
+	bool remove(const K& key);
+
+	std::optional<V> search(const K& key) const;
+
+	// 进入纪元临界区，守卫存活期间 lookup() 返回的指针不会被释放
+	Guard pin() const {
+		return epochs.pin();
+	}
+
+	// 返回值的指针，未找到返回 nullptr。即使该键随后被并发删除，指针在 guard 析构前仍然有效
+	const V* lookup(const K& key, const Guard& guard) const;
+
+	bool contains(const K& key) const;
+
+	void display() const;
+
+	// O(1)。计数在线性化点之后才更新，并发修改期间可能短暂地落后于实际内容
+	int size() const;
+
+	bool empty() const;
+
+	// 第 i 项为高度 >= i 的节点数
+	std::vector<int> levelHistogram() const;
+
+	// 按键升序访问 [lo, hi) 内的元素，只下降一次，之后沿第 0 层前进。
+	// 弱一致性：不加锁也不阻塞写线程，每个键至多访问一次且严格有序；
+	// 扫描开始前已完成的修改一定可见，扫描期间的并发修改可能可见也可能不可见。
+	// 回调返回 false 可提前结束，返回值为访问的元素个数
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+};
+
+template <typename K, typename V, int MaxLevel>
+ConcurrentSkipList<K, V, MaxLevel>::ConcurrentSkipList(int maxLvl, float prob)
+	: maxLevel(std::min(maxLvl, MaxLevel)), p(prob), levelGenerator(p, maxLevel), currentLevel(0),
+	  elementCount(0) {
+	for (int i = 0; i <= MaxLevel; i++) {
+		heightCounts[i].store(0, std::memory_order_relaxed);
+	}
+	K dummyKey{};
+	V dummyValue{};
+	header = NodeType::create(dummyKey, dummyValue, maxLevel);
+}
+
+template <typename K, typename V, int MaxLevel>
+ConcurrentSkipList<K, V, MaxLevel>::~ConcurrentSkipList() {
+	NodeType* current = NodeType::pointer(header->forward[0].load(std::memory_order_relaxed));
+	while (current != nullptr) {
+		NodeType* temp = current;
+		current = NodeType::pointer(current->forward[0].load(std::memory_order_relaxed));
+		NodeType::destroy(temp);
+	}
+	NodeType::destroy(header);
+	// 尚未释放的退休节点由 epochs 的析构函数统一释放
+}
+
+template <typename K, typename V, int MaxLevel>
+int ConcurrentSkipList<K, V, MaxLevel>::getRandomLevel() {
+	return levelGenerator();
+}
+
+template <typename K, typename V, int MaxLevel>
+void ConcurrentSkipList<K, V, MaxLevel>::raiseCurrentLevel(int level) {
+	int observed = currentLevel.load(std::memory_order_relaxed);
+	while (observed < level &&
+		   !currentLevel.compare_exchange_weak(observed, level, std::memory_order_relaxed)) {
+	}
+}
+
+// 在每一层找到 key 的前驱 preds[i] 和后继 succs[i]，
+// 途中遇到被标记的节点就用 CAS 把它从该层摘除，CAS 失败则从头重试
+template <typename K, typename V, int MaxLevel>
+bool ConcurrentSkipList<K, V, MaxLevel>::find(const K& key, NodeType** preds, NodeType** succs) {
+retry:
+	NodeType* pred = header;
+	for (int i = maxLevel; i >= 0; i--) {
+		NodeType* current = NodeType::pointer(pred->forward[i].load(std::memory_order_acquire));
+		while (current != nullptr) {
+			std::uintptr_t next = current->forward[i].load(std::memory_order_acquire);
+			while (NodeType::marked(next)) {
+				// current 在这一层已被逻辑删除，把它从 pred 后面摘掉
+				std::uintptr_t expected = NodeType::pack(current);
+				if (!pred->forward[i].compare_exchange_strong(
+						expected, NodeType::pack(NodeType::pointer(next)),
+						std::memory_order_acq_rel, std::memory_order_acquire)) {
+					goto retry;
+				}
+				current = NodeType::pointer(next);
+				if (current == nullptr) {
+					break;
+				}
+				next = current->forward[i].load(std::memory_order_acquire);
+			}
+			if (current == nullptr || !(current->key < key)) {
+				break;
+			}
+			pred = current;
+			current = NodeType::pointer(next);
+		}
+		preds[i] = pred;
+		succs[i] = current;
+	}
+	return succs[0] != nullptr && succs[0]->key == key;
+}
+
+template <typename K, typename V, int MaxLevel>
+void ConcurrentSkipList<K, V, MaxLevel>::retire(NodeType* node) {
+	// 只有插入者和删除者都确认不会再链接/摘除该节点后，它才真正不可达
+	if (node->pendingUnlinks.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+		return;
+	}
+	epochs.retire(node, [](void* p) { NodeType::destroy(static_cast<NodeType*>(p)); });
+}
+
+template <typename K, typename V, int MaxLevel>
+bool ConcurrentSkipList<K, V, MaxLevel>::insert(const K& key, const V& value) {
+	Guard guard = epochs.pin();
+	NodeArray preds;
+	NodeArray succs;
+
+	int randomLvl = getRandomLevel();
+	NodeType* newNode = nullptr;
+
+	while (true) {
+		if (find(key, preds.data(), succs.data())) {
+			if (newNode != nullptr) {
+				NodeType::destroy(newNode);
+			}
+			return false;
+		}
+
+		if (newNode == nullptr) {
+			newNode = NodeType::create(key, value, randomLvl);
+		}
+		for (int i = 0; i <= randomLvl; i++) {
+			newNode->forward[i].store(NodeType::pack(succs[i]), std::memory_order_relaxed);
+		}
+
+		// 第 0 层 CAS 成功即为插入的线性化点
+		std::uintptr_t expected = NodeType::pack(succs[0]);
+		if (preds[0]->forward[0].compare_exchange_strong(expected, NodeType::pack(newNode),
+														 std::memory_order_release,
+														 std::memory_order_relaxed)) {
+			break;
+		}
+	}
+
+	elementCount.fetch_add(1, std::memory_order_relaxed);
+	heightCounts[randomLvl].fetch_add(1, std::memory_order_relaxed);
+	raiseCurrentLevel(randomLvl);
+
+	// 逐层向上链接，被并发删除时立即停止
+	for (int i = 1; i <= randomLvl; i++) {
+		while (true) {
+			std::uintptr_t link = newNode->forward[i].load(std::memory_order_acquire);
+			if (NodeType::marked(link)) {
+				goto linked;
+			}
+			if (NodeType::pointer(link) != succs[i] &&
+				!newNode->forward[i].compare_exchange_strong(link, NodeType::pack(succs[i]),
+															 std::memory_order_acq_rel)) {
+				continue;
+			}
+
+			std::uintptr_t expected = NodeType::pack(succs[i]);
+			if (preds[i]->forward[i].compare_exchange_strong(expected, NodeType::pack(newNode),
+															 std::memory_order_release,
+															 std::memory_order_relaxed)) {
+				break;
+			}
+
+			find(key, preds.data(), succs.data());
+			if (succs[0] != newNode) {
+				goto linked;
+			}
+		}
+	}
+
+linked:
+	// 链接期间节点可能已被删除者标记，删除者的 find 可能早于我们的链接，
+	// 这里再 find 一次，确保不会留下指向已删除节点的链接
+	if (NodeType::marked(newNode->forward[0].load(std::memory_order_acquire))) {
+		find(key, preds.data(), succs.data());
+	}
+	retire(newNode);
+	return true;
+}
+
+template <typename K, typename V, int MaxLevel>
+bool ConcurrentSkipList<K, V, MaxLevel>::remove(const K& key) {
+	Guard guard = epochs.pin();
+	NodeArray preds;
+	NodeArray succs;
+
+	if (!find(key, preds.data(), succs.data())) {
+		return false;
+	}
+
+	NodeType* victim = succs[0];
+
+	// 自顶向下标记除第 0 层以外的各层
+	for (int i = victim->level; i >= 1; i--) {
+		std::uintptr_t link = victim->forward[i].load(std::memory_order_acquire);
+		while (!NodeType::marked(link)) {
+			victim->forward[i].compare_exchange_weak(link, link | NodeType::kMarkBit,
+													 std::memory_order_acq_rel);
+		}
+	}
+
+	// 标记第 0 层，成功者即为删除的线性化点
+	std::uintptr_t link = victim->forward[0].load(std::memory_order_acquire);
+	while (true) {
+		if (NodeType::marked(link)) {
+			return false; // 被其他线程抢先删除
+		}
+		if (victim->forward[0].compare_exchange_weak(link, link | NodeType::kMarkBit,
+													 std::memory_order_acq_rel)) {
+			break;
+		}
+	}
+
+	elementCount.fetch_sub(1, std::memory_order_relaxed);
+	heightCounts[victim->level].fetch_sub(1, std::memory_order_relaxed);
+
+	// 物理摘除
+	find(key, preds.data(), succs.data());
+	retire(victim);
+	return true;
+}
+
+template <typename K, typename V, int MaxLevel>
+std::optional<V> ConcurrentSkipList<K, V, MaxLevel>::search(const K& key) const {
+	Guard guard = epochs.pin();
+	const V* value = lookup(key, guard);
+	if (value != nullptr) {
+		return *value;
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, int MaxLevel>
+typename ConcurrentSkipList<K, V, MaxLevel>::NodeType*
+ConcurrentSkipList<K, V, MaxLevel>::findGreaterOrEqual(const K& key) const {
+	NodeType* pred = header;
+	NodeType* current = nullptr;
+
+	for (int i = currentLevel.load(std::memory_order_relaxed); i >= 0; i--) {
+		current = NodeType::pointer(pred->forward[i].load(std::memory_order_acquire));
+		while (current != nullptr) {
+			std::uintptr_t next = current->forward[i].load(std::memory_order_acquire);
+			// 跳过被标记的节点，但不帮忙摘除
+			while (NodeType::marked(next)) {
+				current = NodeType::pointer(next);
+				if (current == nullptr) {
+					break;
+				}
+				next = current->forward[i].load(std::memory_order_acquire);
+			}
+			if (current == nullptr || !(current->key < key)) {
+				break;
+			}
+			pred = current;
+			current = NodeType::pointer(next);
+		}
+	}
+
+	return current;
+}
+
+template <typename K, typename V, int MaxLevel>
+typename ConcurrentSkipList<K, V, MaxLevel>::NodeType*
+ConcurrentSkipList<K, V, MaxLevel>::nextUnmarked(NodeType* node) {
+	NodeType* next = NodeType::pointer(node->forward[0].load(std::memory_order_acquire));
+	while (next != nullptr) {
+		std::uintptr_t link = next->forward[0].load(std::memory_order_acquire);
+		if (!NodeType::marked(link)) {
+			break;
+		}
+		next = NodeType::pointer(link);
+	}
+	return next;
+}
+
+template <typename K, typename V, int MaxLevel>
+const V* ConcurrentSkipList<K, V, MaxLevel>::lookup(const K& key, const Guard&) const {
+	NodeType* current = findGreaterOrEqual(key);
+	if (current != nullptr && current->key == key) {
+		return &current->value;
+	}
+	return nullptr;
+}
+
+template <typename K, typename V, int MaxLevel>
+template <typename Callback>
+std::size_t ConcurrentSkipList<K, V, MaxLevel>::scan(const K& lo, const K& hi,
+													 Callback&& callback) const {
+	Guard guard = epochs.pin();
+
+	std::size_t visited = 0;
+	for (NodeType* node = findGreaterOrEqual(lo); node != nullptr && node->key < hi;
+		 node = nextUnmarked(node)) {
+		visited++;
+		if (!detail::invokeScanCallback(callback, node->key, node->value)) {
+			break;
+		}
+	}
+	return visited;
+}
+
+template <typename K, typename V, int MaxLevel>
+bool ConcurrentSkipList<K, V, MaxLevel>::contains(const K& key) const {
+	Guard guard = epochs.pin();
+	return lookup(key, guard) != nullptr;
+}
+
+template <typename K, typename V, int MaxLevel>
+void ConcurrentSkipList<K, V, MaxLevel>::display() const {
+	Guard guard = epochs.pin();
+	std::cout << "\n***** Concurrent Skip List *****\n";
+	for (int i = currentLevel.load(); i >= 0; i--) {
+		std::uintptr_t link = header->forward[i].load(std::memory_order_acquire);
+		std::cout << "Level " << i << ": ";
+		while (NodeType::pointer(link) != nullptr) {
+			NodeType* node = NodeType::pointer(link);
+			link = node->forward[i].load(std::memory_order_acquire);
+			if (!NodeType::marked(link)) {
+				std::cout << node->key << ":" << node->value << " ";
+			}
+		}
+		std::cout << std::endl;
+	}
+}
+
+template <typename K, typename V, int MaxLevel>
+int ConcurrentSkipList<K, V, MaxLevel>::size() const {
+	return elementCount.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename V, int MaxLevel>
+bool ConcurrentSkipList<K, V, MaxLevel>::empty() const {
+	return size() == 0;
+}
+
+template <typename K, typename V, int MaxLevel>
+std::vector<int> ConcurrentSkipList<K, V, MaxLevel>::levelHistogram() const {
+	std::vector<int> histogram(maxLevel + 1, 0);
+	int nodesAbove = 0;
+	for (int i = maxLevel; i >= 0; i--) {
+		nodesAbove += heightCounts[i].load(std::memory_order_relaxed);
+		histogram[i] = nodesAbove;
+	}
+	return histogram;
+}
+
+} // namespace skiplist
+
+#endif // CONCURRENT_SKIPLIST_HPP
@@ -0,0 +1,35 @@
+#ifndef DETAIL_HPP
+#define DETAIL_HPP
+
+#include <type_traits>
+#include <utility>
+
+namespace skiplist {
+
+namespace detail {
+
+// 调用范围扫描的回调。回调可以返回 void，也可以返回 bool，返回 false 表示提前结束扫描
+template <typename Callback, typename K, typename V>
+bool invokeScanCallback(Callback& callback, const K& key, const V& value) {
+	if constexpr (std::is_void_v<std::invoke_result_t<Callback&, const K&, const V&>>) {
+		callback(key, value);
+		return true;
+	} else {
+		return static_cast<bool>(callback(key, value));
+	}
+}
+
+// 软件预取：提示 CPU 提前把 address 所在的缓存行读进缓存，不会因为地址无效（包括空指针）而出错
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address, 0, 3);
+#else
+	(void)address;
+#endif
+}
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // DETAIL_HPP
@@ -0,0 +1,263 @@
+#ifndef DURABLE_SKIPLIST_HPP
+#define DURABLE_SKIPLIST_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "skiplist.hpp"
+#include "wal.hpp"
+
+namespace skiplist {
+
+// 带预写日志的 SkipList。每次修改先追加到日志缓冲区并等待落盘，落盘之后才作用到内存中的跳表再返回，
+// 因此读者看到的修改一定能在崩溃后恢复。并发的写入通过组提交共用 fsync（见 wal.hpp）。
+// 启动时 open() 先加载快照再重放日志；checkpoint() 写出新快照并清空日志，限制日志长度和恢复时间。
+// 只有真正改变了跳表的操作才写日志（已存在的键 insert、不存在的键 remove 不写），
+// 是否改变按跳表加上已追加、尚未生效的修改判断。
+// 日志写入失败后 healthy() 返回 false，之后的修改全部被拒绝。失败的那次修改（以及与它同一批提交的
+// 其他修改）不会作用到跳表，它们的调用都返回 false
+template <typename K, typename V, typename Compare = std::less<K>,
+		  typename Alloc = NewDeleteAllocator, int MaxLevel = 32>
+class DurableSkipList {
+public:
+	using List = SkipList<K, V, Compare, Alloc, MaxLevel>;
+
+private:
+	List list;
+	WriteAheadLog<K, V> log;
+	std::string snapshotPath;
+	// 已追加到日志、等待落盘后才作用到跳表的修改
+	struct PendingWrite {
+		std::uint64_t sequence;
+		WalOp op;
+		K key;
+		V value;
+	};
+
+	// 保护追加日志、inFlight 和把修改作用到跳表，日志中的顺序就是修改生效的顺序。锁内只有内存操作，
+	// 等待落盘在锁外进行，这样多个写者的 fsync 才能合并
+	std::mutex writeMutex;
+	std::condition_variable published; // inFlight 变短或 checkpoint 结束
+	std::deque<PendingWrite> inFlight; // 按序号排列
+	bool checkpointing = false;        // 为 true 时新的写入等待，checkpoint 等 inFlight 清空
+	std::atomic<bool> logHealthy{false};
+	bool syncWrites = true; // open() 的 sync 参数，checkpoint 写快照时同样据此决定是否 fsync
+
+	// key 当前是否存在：尚未生效的修改中最新的一条优先，没有时看跳表。调用者需持有 writeMutex
+	bool containsLocked(const K& key) const;
+
+	// 在 writeMutex 内调用 check，返回 true 时追加日志并登记到 inFlight，然后在锁外等待落盘。
+	// 落盘后把序号不大于它的修改按顺序作用到跳表。check 返回 false、日志已经失败或这次落盘失败时返回 false
+	template <typename Check>
+	bool apply(WalOp op, const K& key, const V& value, Check&& check);
+
+	// checkpoint 的主体，调用者持有 writeMutex 且没有尚未生效的修改
+	bool saveAndReset();
+
+public:
+	explicit DurableSkipList(int maxLvl = MaxLevel, float prob = 0.5, Alloc alloc = Alloc(),
+							 Compare comp = Compare())
+		: list(maxLvl, prob, std::move(alloc), std::move(comp)) {}
+
+	DurableSkipList(const DurableSkipList&) = delete;
+	DurableSkipList& operator=(const DurableSkipList&) = delete;
+
+	// 加载快照（不存在时从空表开始）、重放日志并打开日志用于追加，只能在空表上调用一次。
+	// sync 为 false 时不调用 fsync，只保证进程崩溃后可恢复。快照损坏或文件无法读写时返回 false
+	bool open(const std::string& snapshot, const std::string& logPath, bool sync = true);
+
+	// 写出尚未写出的日志并关闭。析构时自动调用
+	void close() {
+		log.close();
+		logHealthy.store(false);
+	}
+
+	// 与 SkipList 的同名接口相同，返回 true 时修改已经落盘。返回 false 且 healthy() 为 false
+	// 表示日志写入失败（见类的注释），而不是键已存在或不存在
+	bool insert(const K& key, const V& value);
+
+	// 插入了新键且已落盘时返回 true。覆盖已有的值或日志写入失败时返回 false，后者 healthy() 为 false
+	bool insert_or_assign(const K& key, const V& value);
+
+	bool remove(const K& key);
+
+	// 把当前内容保存为快照并清空日志。期间阻塞写入，读取不受影响
+	bool checkpoint();
+
+	bool healthy() const {
+		return logHealthy.load();
+	}
+
+	std::optional<V> search(const K& key) const {
+		return list.search(key);
+	}
+
+	bool contains(const K& key) const {
+		return list.contains(key);
+	}
+
+	int size() const {
+		return list.size();
+	}
+
+	bool empty() const {
+		return list.empty();
+	}
+
+	// 只读访问底层跳表（迭代器、范围扫描等）。不要通过其他途径修改它，否则修改不会写入日志
+	const List& view() const {
+		return list;
+	}
+
+	// 上次 open() 时重放的日志记录数
+	std::size_t replayed() const {
+		return log.replayed();
+	}
+
+	// 日志实际写文件（并 fsync）的次数
+	std::uint64_t syncs() {
+		return log.syncs();
+	}
+};
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::open(const std::string& snapshot,
+														   const std::string& logPath, bool sync) {
+	std::lock_guard<std::mutex> lock(writeMutex);
+	std::error_code error;
+	if (std::filesystem::exists(snapshot, error) && !list.loadFrom(snapshot)) {
+		return false;
+	}
+	if (error) {
+		return false;
+	}
+
+	bool opened = log.open(
+		logPath,
+		[this](WalOp op, const K& key, const V& value) {
+			if (op == WalOp::Put) {
+				list.insert_or_assign(key, value);
+			} else {
+				list.remove(key);
+			}
+		},
+		sync);
+	snapshotPath = snapshot;
+	syncWrites = sync;
+	logHealthy.store(opened);
+	return opened;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::containsLocked(const K& key) const {
+	Compare less = list.key_comp();
+	for (auto it = inFlight.rbegin(); it != inFlight.rend(); ++it) {
+		if (!less(key, it->key) && !less(it->key, key)) {
+			return it->op == WalOp::Put;
+		}
+	}
+	return list.contains(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Check>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::apply(WalOp op, const K& key, const V& value,
+															Check&& check) {
+	std::unique_lock<std::mutex> lock(writeMutex);
+	published.wait(lock, [this] { return !checkpointing; });
+	if (!logHealthy.load() || !check()) {
+		return false;
+	}
+	std::uint64_t sequence = op == WalOp::Put ? log.appendPut(key, value) : log.appendRemove(key);
+	inFlight.push_back(PendingWrite{sequence, op, key, value});
+	lock.unlock();
+
+	bool durable = log.commit(sequence);
+
+	lock.lock();
+	if (durable) {
+		// 日志按序号成批落盘，序号更小的修改同样已经落盘，按顺序一并生效
+		while (!inFlight.empty() && inFlight.front().sequence <= sequence) {
+			PendingWrite& write = inFlight.front();
+			if (write.op == WalOp::Put) {
+				list.insert_or_assign(std::move(write.key), std::move(write.value));
+			} else {
+				list.remove(write.key);
+			}
+			inFlight.pop_front();
+		}
+	} else {
+		// 这一批及之后的记录都没有落盘，丢弃而不作用到跳表
+		logHealthy.store(false);
+		while (!inFlight.empty() && inFlight.back().sequence >= sequence) {
+			inFlight.pop_back();
+		}
+	}
+	published.notify_all();
+	return durable;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::insert(const K& key, const V& value) {
+	return apply(WalOp::Put, key, value, [&] { return !containsLocked(key); });
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::insert_or_assign(const K& key,
+																	   const V& value) {
+	bool inserted = false;
+	bool durable = apply(WalOp::Put, key, value, [&] {
+		inserted = !containsLocked(key);
+		return true; // 覆盖已有的值同样需要写日志
+	});
+	return durable && inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::remove(const K& key) {
+	return apply(WalOp::Remove, key, V(), [&] { return containsLocked(key); });
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::checkpoint() {
+	std::unique_lock<std::mutex> lock(writeMutex);
+	published.wait(lock, [this] { return !checkpointing; });
+	if (!logHealthy.load()) {
+		return false;
+	}
+	// 已追加的记录全部生效之后再写快照，否则清空日志会丢掉还没进入快照的修改。期间新的写入等待
+	checkpointing = true;
+	published.wait(lock, [this] { return inFlight.empty(); });
+	bool saved = saveAndReset();
+	checkpointing = false;
+	published.notify_all();
+	return saved;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool DurableSkipList<K, V, Compare, Alloc, MaxLevel>::saveAndReset() {
+	// 快照先以改名的方式原子替换，并且连同目录项一起落盘之后才清空日志，
+	// 否则掉电后可能快照还没写回、日志却已经被截断。两步之间崩溃时日志会在新快照上重放一遍，
+	// Put/Remove 都是幂等的，结果不变
+	if (!list.saveTo(snapshotPath, syncWrites)) {
+		return false;
+	}
+	if (!log.reset()) {
+		logHealthy.store(false);
+		return false;
+	}
+	return true;
+}
+
+} // namespace skiplist
+
+#endif // DURABLE_SKIPLIST_HPP
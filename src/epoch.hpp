@@ -0,0 +1,293 @@
+#ifndef EPOCH_HPP
+#define EPOCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace skiplist {
+
+namespace detail {
+
+// 存活的 EpochManager 编号。线程退出时据此判断其缓存的线程记录是否还能访问
+inline std::mutex& epochRegistryMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+inline std::unordered_set<std::uint64_t>& liveEpochManagers() {
+	static std::unordered_set<std::uint64_t> managers;
+	return managers;
+}
+
+inline std::uint64_t nextEpochManagerId() {
+	static std::atomic<std::uint64_t> id{0};
+	return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace detail
+
+// 基于纪元（epoch）的内存回收
+//
+// 读者在访问共享节点前通过 pin() 进入临界区并公布自己观察到的全局纪元；
+// 写者把摘除的节点 retire() 到本线程的回收桶里，桶按纪元分成三组。
+// 只有当所有处于临界区的线程都已观察到当前纪元时全局纪元才会前进，
+// 因此纪元 e 中退休的节点在全局纪元达到 e + 2 后一定不会再被任何读者持有，可以批量释放。
+class EpochManager {
+private:
+	struct Retired {
+		void* pointer;
+		void (*deleter)(void*);
+	};
+
+	struct RetireBucket {
+		std::uint64_t epoch = 0;
+		std::vector<Retired> items;
+	};
+
+	static constexpr int kBucketCount = 3;
+	// 每退休这么多个对象尝试推进一次纪元，把回收成本摊到批量操作上
+	static constexpr std::size_t kReclaimBatch = 64;
+
+	struct ThreadRecord {
+		// (纪元 << 1) | 是否处于临界区
+		std::atomic<std::uint64_t> state{0};
+		std::atomic<bool> inUse{true};
+		ThreadRecord* next = nullptr;
+		// 以下字段只由当前持有该记录的线程访问
+		int nesting = 0;
+		std::size_t retiredSinceReclaim = 0;
+		RetireBucket buckets[kBucketCount];
+	};
+
+	// 每个线程缓存自己在各个 EpochManager 中占用的记录
+	struct ThreadCache {
+		std::vector<std::pair<std::uint64_t, ThreadRecord*>> records;
+
+		~ThreadCache() {
+			// 线程退出时交还记录，未释放的退休对象留给下一个接手的线程或析构函数
+			std::lock_guard<std::mutex> lock(detail::epochRegistryMutex());
+			for (auto& entry : records) {
+				if (detail::liveEpochManagers().count(entry.first) != 0) {
+					entry.second->inUse.store(false, std::memory_order_release);
+				}
+			}
+		}
+	};
+
+	const std::uint64_t id;
+	std::atomic<std::uint64_t> globalEpoch;
+	std::atomic<ThreadRecord*> records;
+
+	static ThreadCache& threadCache() {
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	ThreadRecord* localRecord();
+
+	ThreadRecord* acquireRecord();
+
+	bool tryAdvance();
+
+	void reclaim(ThreadRecord* record);
+
+	static void freeBucket(RetireBucket& bucket) {
+		for (const Retired& item : bucket.items) {
+			item.deleter(item.pointer);
+		}
+		bucket.items.clear();
+	}
+
+	void exit(ThreadRecord* record) {
+		if (--record->nesting == 0) {
+			record->state.store(record->state.load(std::memory_order_relaxed) & ~std::uint64_t{1},
+								std::memory_order_release);
+		}
+	}
+
+public:
+	// RAII 临界区守卫，持有期间读到的节点都不会被释放。可嵌套
+	class Guard {
+	private:
+		EpochManager* manager;
+		ThreadRecord* record;
+
+		friend class EpochManager;
+
+		Guard(EpochManager* m, ThreadRecord* r) : manager(m), record(r) {}
+
+	public:
+		Guard(Guard&& other) noexcept : manager(other.manager), record(other.record) {
+			other.manager = nullptr;
+		}
+
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+		Guard& operator=(Guard&&) = delete;
+
+		~Guard() {
+			if (manager != nullptr) {
+				manager->exit(record);
+			}
+		}
+	};
+
+	EpochManager();
+	~EpochManager();
+
+	EpochManager(const EpochManager&) = delete;
+	EpochManager& operator=(const EpochManager&) = delete;
+
+	Guard pin();
+
+	// 延迟释放 pointer，调用者需保证此时它已对新的读者不可达
+	void retire(void* pointer, void (*deleter)(void*));
+
+	template <typename T>
+	void retire(T* pointer) {
+		retire(static_cast<void*>(pointer), [](void* p) { delete static_cast<T*>(p); });
+	}
+
+	// 尽力推进纪元并释放本线程可回收的对象，主要用于测试和空闲时清理
+	void collect();
+
+	std::uint64_t epoch() const {
+		return globalEpoch.load(std::memory_order_acquire);
+	}
+};
+
+inline EpochManager::EpochManager()
+	: id(detail::nextEpochManagerId()), globalEpoch(0), records(nullptr) {
+	std::lock_guard<std::mutex> lock(detail::epochRegistryMutex());
+	detail::liveEpochManagers().insert(id);
+}
+
+// 析构时要求没有线程处于临界区
+inline EpochManager::~EpochManager() {
+	{
+		std::lock_guard<std::mutex> lock(detail::epochRegistryMutex());
+		detail::liveEpochManagers().erase(id);
+	}
+
+	ThreadRecord* record = records.load(std::memory_order_acquire);
+	while (record != nullptr) {
+		ThreadRecord* next = record->next;
+		for (RetireBucket& bucket : record->buckets) {
+			freeBucket(bucket);
+		}
+		delete record;
+		record = next;
+	}
+}
+
+inline EpochManager::ThreadRecord* EpochManager::localRecord() {
+	ThreadCache& cache = threadCache();
+	for (auto& entry : cache.records) {
+		if (entry.first == id) {
+			return entry.second;
+		}
+	}
+
+	ThreadRecord* record = acquireRecord();
+	{
+		// 顺便清掉已析构的 EpochManager 留下的缓存项
+		std::lock_guard<std::mutex> lock(detail::epochRegistryMutex());
+		auto& live = detail::liveEpochManagers();
+		auto& entries = cache.records;
+		for (std::size_t i = 0; i < entries.size();) {
+			if (live.count(entries[i].first) == 0) {
+				entries[i] = entries.back();
+				entries.pop_back();
+			} else {
+				i++;
+			}
+		}
+	}
+	cache.records.emplace_back(id, record);
+	return record;
+}
+
+inline EpochManager::ThreadRecord* EpochManager::acquireRecord() {
+	// 优先复用已退出线程交还的记录
+	for (ThreadRecord* record = records.load(std::memory_order_acquire); record != nullptr;
+		 record = record->next) {
+		bool expected = false;
+		if (!record->inUse.load(std::memory_order_relaxed) &&
+			record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			return record;
+		}
+	}
+
+	ThreadRecord* record = new ThreadRecord();
+	ThreadRecord* head = records.load(std::memory_order_relaxed);
+	do {
+		record->next = head;
+	} while (!records.compare_exchange_weak(head, record, std::memory_order_release,
+											std::memory_order_relaxed));
+	return record;
+}
+
+inline EpochManager::Guard EpochManager::pin() {
+	ThreadRecord* record = localRecord();
+	if (record->nesting++ == 0) {
+		std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+		record->state.store((e << 1) | 1, std::memory_order_seq_cst);
+		// 公布纪元必须先于之后对共享节点的任何读取
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+	return Guard(this, record);
+}
+
+inline bool EpochManager::tryAdvance() {
+	std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+	for (ThreadRecord* record = records.load(std::memory_order_acquire); record != nullptr;
+		 record = record->next) {
+		std::uint64_t state = record->state.load(std::memory_order_seq_cst);
+		if ((state & 1) != 0 && (state >> 1) != e) {
+			return false; // 仍有线程停留在旧纪元
+		}
+	}
+	return globalEpoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+}
+
+inline void EpochManager::reclaim(ThreadRecord* record) {
+	std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+	for (RetireBucket& bucket : record->buckets) {
+		if (!bucket.items.empty() && bucket.epoch + 2 <= e) {
+			freeBucket(bucket);
+		}
+	}
+	record->retiredSinceReclaim = 0;
+}
+
+inline void EpochManager::retire(void* pointer, void (*deleter)(void*)) {
+	ThreadRecord* record = localRecord();
+	std::uint64_t e = globalEpoch.load(std::memory_order_seq_cst);
+	RetireBucket& bucket = record->buckets[e % kBucketCount];
+	if (bucket.epoch != e) {
+		// 同一个桶里只可能是 e - 3 或更早退休的对象，已经可以释放
+		freeBucket(bucket);
+		bucket.epoch = e;
+	}
+	bucket.items.push_back(Retired{pointer, deleter});
+
+	if (++record->retiredSinceReclaim >= kReclaimBatch) {
+		tryAdvance();
+		reclaim(record);
+	}
+}
+
+inline void EpochManager::collect() {
+	ThreadRecord* record = localRecord();
+	tryAdvance();
+	reclaim(record);
+}
+
+} // namespace skiplist
+
+#endif // EPOCH_HPP
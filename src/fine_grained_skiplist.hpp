@@ -0,0 +1,378 @@
+#ifndef FINE_GRAINED_SKIPLIST_HPP
+#define FINE_GRAINED_SKIPLIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "detail.hpp"
+#include "epoch.hpp"
+#include "level_generator.hpp"
+#include "node.hpp"
+
+namespace skiplist {
+
+// 细粒度锁跳表（乐观加锁的 lazy skiplist，Herlihy、Lev、Luchangco、Shavit 2006）
+//
+// - 没有全局锁。insert/remove 先不加锁地找出各层的前驱 preds 和后继 succs，
+//   再只锁住这些前驱节点，并验证它们未被删除、且仍然指向 succs；验证失败就释放锁重新查找
+// - 加锁顺序始终是从大键到小键（先第 0 层的前驱，再向上），remove 先锁被删节点，因此不会死锁
+// - remove 在被删节点的锁内设置 marked（线性化点），然后在前驱的锁内自顶向下摘除
+// - insert 在所有层链接完成后设置 fullyLinked（线性化点）；查找只认 fullyLinked 且未 marked 的节点
+// - search/contains/scan 不加任何锁，只读取原子发布的 forward 指针
+//
+// 键不相交的写入只会在前驱恰好相同时竞争同一把节点锁，因此可以并行进行。
+// 摘除的节点通过 EpochManager 延迟释放，与 ConcurrentSkipList 相同
+template <typename K, typename V, typename Compare = std::less<K>, int MaxLevel = 32>
+class FineGrainedSkipList {
+	static_assert(MaxLevel >= 0, "MaxLevel must be non-negative");
+
+private:
+	using NodeType = LockedNode<K, V>;
+	using NodeArray = std::array<NodeType*, MaxLevel + 1>;
+
+	int maxLevel;
+	float p;
+	detail::LevelGenerator levelGenerator;
+	Compare comp;
+	std::atomic<int> currentLevel; // 只增不减
+	NodeType* header;
+	mutable EpochManager epochs;
+	std::atomic<int> elementCount;
+	std::atomic<int> heightCounts[MaxLevel + 1];
+
+	// 不加锁地找出各层的前驱和后继，返回 key 所在的最高层，不存在时返回 -1
+	int find(const K& key, NodeType** preds, NodeType** succs) const;
+
+	// 锁住 preds[0..top]（相邻层相同的前驱只锁一次），并用 check(level) 验证各层。
+	// 验证失败时释放已加的锁并返回 false
+	template <typename Check>
+	bool lockPredecessors(NodeType** preds, int top, Check check) const;
+
+	static void unlockPredecessors(NodeType** preds, int top);
+
+	// 只读下降，返回第一个键 >= key 的节点（可能是未完成链接或已被删除的节点）
+	NodeType* findGreaterOrEqual(const K& key) const;
+
+	static bool visible(const NodeType* node) {
+		return node->fullyLinked.load(std::memory_order_acquire) &&
+			   !node->marked.load(std::memory_order_acquire);
+	}
+
+	void raiseCurrentLevel(int level);
+
+public:
+	using Guard = EpochManager::Guard;
+
+	explicit FineGrainedSkipList(int maxLvl = MaxLevel, float prob = 0.5,
+								 Compare c = Compare());
+	~FineGrainedSkipList();
+
+	FineGrainedSkipList(const FineGrainedSkipList&) = delete;
+	FineGrainedSkipList& operator=(const FineGrainedSkipList&) = delete;
+
+	int getRandomLevel();
+
+	// 插入成功返回 true，键已存在返回 false
+	bool insert(const K& key, const V& value);
+
+	// 本线程成功删除该键时返回 true
+	bool remove(const K& key);
+
+	std::optional<V> search(const K& key) const;
+
+	bool contains(const K& key) const;
+
+	// 进入纪元临界区，守卫存活期间 lookup() 返回的指针不会被释放
+	Guard pin() const {
+		return epochs.pin();
+	}
+
+	// 返回值的指针，未找到返回 nullptr。即使该键随后被并发删除，指针在 guard 析构前仍然有效
+	const V* lookup(const K& key, const Guard& guard) const;
+
+	// O(1)。计数在线性化点之后才更新，并发修改期间可能短暂地落后于实际内容
+	int size() const {
+		return elementCount.load(std::memory_order_relaxed);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// 第 i 项为高度 >= i 的节点数
+	std::vector<int> levelHistogram() const;
+
+	// 按键升序访问 [lo, hi) 内的元素。与 ConcurrentSkipList::scan 相同，是弱一致的：
+	// 不加锁，扫描开始前已完成的修改一定可见，扫描期间的并发修改可能可见也可能不可见
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+};
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+FineGrainedSkipList<K, V, Compare, MaxLevel>::FineGrainedSkipList(int maxLvl, float prob,
+																  Compare c)
+	: maxLevel(std::min(maxLvl, MaxLevel)), p(prob), levelGenerator(p, maxLevel),
+	  comp(std::move(c)), currentLevel(0), elementCount(0) {
+	for (int i = 0; i <= MaxLevel; i++) {
+		heightCounts[i].store(0, std::memory_order_relaxed);
+	}
+	header = NodeType::create(K{}, V{}, maxLevel);
+	header->fullyLinked.store(true, std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+FineGrainedSkipList<K, V, Compare, MaxLevel>::~FineGrainedSkipList() {
+	NodeType* current = header->forward[0].load(std::memory_order_relaxed);
+	while (current != nullptr) {
+		NodeType* next = current->forward[0].load(std::memory_order_relaxed);
+		NodeType::destroy(current);
+		current = next;
+	}
+	NodeType::destroy(header);
+	// 已摘除但尚未释放的节点由 epochs 的析构函数统一释放
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+int FineGrainedSkipList<K, V, Compare, MaxLevel>::getRandomLevel() {
+	return levelGenerator();
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+void FineGrainedSkipList<K, V, Compare, MaxLevel>::raiseCurrentLevel(int level) {
+	int observed = currentLevel.load(std::memory_order_relaxed);
+	while (observed < level &&
+		   !currentLevel.compare_exchange_weak(observed, level, std::memory_order_relaxed)) {
+	}
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+int FineGrainedSkipList<K, V, Compare, MaxLevel>::find(const K& key, NodeType** preds,
+													   NodeType** succs) const {
+	// 写者需要所有可能用到的层，因此从 maxLevel 开始；header 的高层链接多为空，下降很快
+	int found = -1;
+	NodeType* pred = header;
+	for (int i = maxLevel; i >= 0; i--) {
+		NodeType* current = pred->forward[i].load(std::memory_order_acquire);
+		while (current != nullptr && comp(current->key, key)) {
+			pred = current;
+			current = pred->forward[i].load(std::memory_order_acquire);
+		}
+		if (found < 0 && current != nullptr && !comp(key, current->key)) {
+			found = i;
+		}
+		preds[i] = pred;
+		succs[i] = current;
+	}
+	return found;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+template <typename Check>
+bool FineGrainedSkipList<K, V, Compare, MaxLevel>::lockPredecessors(NodeType** preds, int top,
+																	Check check) const {
+	for (int i = 0; i <= top; i++) {
+		if (i == 0 || preds[i] != preds[i - 1]) {
+			preds[i]->lock.lock();
+		}
+		if (preds[i]->marked.load(std::memory_order_acquire) || !check(i)) {
+			unlockPredecessors(preds, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+void FineGrainedSkipList<K, V, Compare, MaxLevel>::unlockPredecessors(NodeType** preds,
+																	  int top) {
+	for (int i = 0; i <= top; i++) {
+		if (i == 0 || preds[i] != preds[i - 1]) {
+			preds[i]->lock.unlock();
+		}
+	}
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+bool FineGrainedSkipList<K, V, Compare, MaxLevel>::insert(const K& key, const V& value) {
+	Guard guard = epochs.pin();
+	NodeArray preds;
+	NodeArray succs;
+	int topLevel = getRandomLevel();
+	// 在加锁之前分配并拷贝键值：构造抛出异常时不会留下锁住的前驱，锁内也不调用分配器
+	NodeType* node = NodeType::create(key, value, topLevel);
+
+	while (true) {
+		int found = find(key, preds.data(), succs.data());
+		if (found >= 0) {
+			NodeType* existing = succs[found];
+			if (!existing->marked.load(std::memory_order_acquire)) {
+				// 键已存在：等它完成链接再返回，保证随后的查找一定能看到它
+				while (!existing->fullyLinked.load(std::memory_order_acquire)) {
+					std::this_thread::yield();
+				}
+				NodeType::destroy(node); // 从未发布，其他线程看不到它，可以直接释放
+				return false;
+			}
+			std::this_thread::yield(); // 正在被删除，等删除完成后重试
+			continue;
+		}
+
+		bool locked = lockPredecessors(preds.data(), topLevel, [&](int i) {
+			NodeType* succ = succs[i];
+			return (succ == nullptr || !succ->marked.load(std::memory_order_acquire)) &&
+				   preds[i]->forward[i].load(std::memory_order_acquire) == succ;
+		});
+		if (!locked) {
+			continue;
+		}
+
+		for (int i = 0; i <= topLevel; i++) {
+			node->forward[i].store(succs[i], std::memory_order_relaxed);
+		}
+		// 自底向上发布：读者经由某一层看到节点时，它在更低层一定也已可达
+		for (int i = 0; i <= topLevel; i++) {
+			preds[i]->forward[i].store(node, std::memory_order_release);
+		}
+		node->fullyLinked.store(true, std::memory_order_release);
+		unlockPredecessors(preds.data(), topLevel);
+
+		elementCount.fetch_add(1, std::memory_order_relaxed);
+		heightCounts[topLevel].fetch_add(1, std::memory_order_relaxed);
+		raiseCurrentLevel(topLevel);
+		return true;
+	}
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+bool FineGrainedSkipList<K, V, Compare, MaxLevel>::remove(const K& key) {
+	Guard guard = epochs.pin();
+	NodeArray preds;
+	NodeArray succs;
+	NodeType* victim = nullptr;
+
+	while (true) {
+		int found = find(key, preds.data(), succs.data());
+		if (victim == nullptr) {
+			// 只删除已经完成链接、且是在自己的最高层上找到的节点（否则它的高层还没链接好）
+			if (found < 0) {
+				return false;
+			}
+			NodeType* candidate = succs[found];
+			if (!candidate->fullyLinked.load(std::memory_order_acquire) ||
+				candidate->level != found || candidate->marked.load(std::memory_order_acquire)) {
+				return false;
+			}
+			candidate->lock.lock();
+			if (candidate->marked.load(std::memory_order_relaxed)) {
+				candidate->lock.unlock();
+				return false; // 被其他线程抢先删除
+			}
+			candidate->marked.store(true, std::memory_order_release);
+			victim = candidate;
+		}
+
+		// victim 的锁一直持有到摘除完成，期间没有节点能插入到它后面
+		int top = victim->level;
+		bool locked = lockPredecessors(preds.data(), top, [&](int i) {
+			return preds[i]->forward[i].load(std::memory_order_acquire) == victim;
+		});
+		if (!locked) {
+			continue;
+		}
+
+		for (int i = top; i >= 0; i--) {
+			preds[i]->forward[i].store(victim->forward[i].load(std::memory_order_relaxed),
+									   std::memory_order_release);
+		}
+		victim->lock.unlock();
+		unlockPredecessors(preds.data(), top);
+
+		elementCount.fetch_sub(1, std::memory_order_relaxed);
+		heightCounts[top].fetch_sub(1, std::memory_order_relaxed);
+		// 没有前驱再指向 victim，但读者可能正停在它上面，交给纪元回收延迟释放
+		epochs.retire(victim, [](void* node) { NodeType::destroy(static_cast<NodeType*>(node)); });
+		return true;
+	}
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+typename FineGrainedSkipList<K, V, Compare, MaxLevel>::NodeType*
+FineGrainedSkipList<K, V, Compare, MaxLevel>::findGreaterOrEqual(const K& key) const {
+	NodeType* pred = header;
+	NodeType* current = nullptr;
+	for (int i = currentLevel.load(std::memory_order_relaxed); i >= 0; i--) {
+		current = pred->forward[i].load(std::memory_order_acquire);
+		while (current != nullptr && comp(current->key, key)) {
+			pred = current;
+			current = pred->forward[i].load(std::memory_order_acquire);
+		}
+	}
+	return current;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+const V* FineGrainedSkipList<K, V, Compare, MaxLevel>::lookup(const K& key, const Guard&) const {
+	NodeType* node = findGreaterOrEqual(key);
+	if (node != nullptr && !comp(key, node->key) && visible(node)) {
+		return &node->value;
+	}
+	return nullptr;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+std::optional<V> FineGrainedSkipList<K, V, Compare, MaxLevel>::search(const K& key) const {
+	Guard guard = epochs.pin();
+	const V* value = lookup(key, guard);
+	if (value != nullptr) {
+		return *value;
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+bool FineGrainedSkipList<K, V, Compare, MaxLevel>::contains(const K& key) const {
+	Guard guard = epochs.pin();
+	return lookup(key, guard) != nullptr;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+std::vector<int> FineGrainedSkipList<K, V, Compare, MaxLevel>::levelHistogram() const {
+	std::vector<int> histogram(maxLevel + 1, 0);
+	int atOrAbove = 0;
+	for (int i = maxLevel; i >= 0; i--) {
+		atOrAbove += heightCounts[i].load(std::memory_order_relaxed);
+		histogram[i] = atOrAbove;
+	}
+	return histogram;
+}
+
+template <typename K, typename V, typename Compare, int MaxLevel>
+template <typename Callback>
+std::size_t FineGrainedSkipList<K, V, Compare, MaxLevel>::scan(const K& lo, const K& hi,
+															   Callback&& callback) const {
+	Guard guard = epochs.pin();
+
+	std::size_t visited = 0;
+	for (NodeType* node = findGreaterOrEqual(lo); node != nullptr && comp(node->key, hi);
+		 node = node->forward[0].load(std::memory_order_acquire)) {
+		// 已摘除的节点的 forward 仍指向原来的后继，沿着它走不会跳过仍在表中的键
+		if (!visible(node)) {
+			continue;
+		}
+		visited++;
+		if (!detail::invokeScanCallback(callback, node->key, node->value)) {
+			break;
+		}
+	}
+	return visited;
+}
+
+} // namespace skiplist
+
+#endif // FINE_GRAINED_SKIPLIST_HPP
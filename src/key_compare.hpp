@@ -0,0 +1,205 @@
+#ifndef KEY_COMPARE_HPP
+#define KEY_COMPARE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "successor_keys.hpp"
+
+namespace skiplist {
+
+// 键前缀扩展点。特化 KeyPrefix<K> 并提供
+//
+//   static constexpr bool kEnabled = true;
+//   static std::uint64_t make(const K& key);  // 也可以接受其他可与 K 比较的查找键类型
+//
+// 节点就会在键旁边额外保存一个 64 位前缀，遍历时先比较前缀，只有前缀相等才比较完整的键。
+// 前缀必须与升序一致：make(a) < make(b) 时一定有 a < b；前缀相等时不做任何推断。
+// 只有比较器为 std::less<K> 或 std::less<> 时才会使用前缀
+template <typename K>
+struct KeyPrefix {
+	static constexpr bool kEnabled = false;
+};
+
+// std::string：前 8 个字节按大端拼成整数，不足 8 字节补 0。
+// std::string 按 unsigned char 逐字节比较，因此整数的大小顺序与字典序一致
+template <>
+struct KeyPrefix<std::string> {
+	static constexpr bool kEnabled = true;
+
+	static std::uint64_t make(std::string_view key) {
+		std::uint64_t prefix = 0;
+		std::size_t length = key.size() < 8 ? key.size() : 8;
+		for (std::size_t i = 0; i < length; i++) {
+			prefix |= std::uint64_t{static_cast<unsigned char>(key[i])} << (56 - 8 * i);
+		}
+		return prefix;
+	}
+};
+
+namespace detail {
+
+template <typename Compare, typename = void>
+struct IsTransparent : std::false_type {};
+
+template <typename Compare>
+struct IsTransparent<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+// 异构查找重载的启用条件（与 std::map 相同）：比较器声明了 is_transparent，且 Key 不是 K 本身
+template <typename Compare, typename K, typename Key>
+using EnableIfTransparent =
+	std::enable_if_t<IsTransparent<Compare>::value && !std::is_same_v<K, Key>>;
+
+// 能否由查找键 Key 算出 K 的前缀
+template <typename K, typename Key, typename = void>
+struct HasKeyPrefix : std::false_type {};
+
+template <typename K, typename Key>
+struct HasKeyPrefix<K, Key, std::void_t<decltype(KeyPrefix<K>::make(std::declval<const Key&>()))>>
+	: std::bool_constant<KeyPrefix<K>::kEnabled> {};
+
+template <typename T>
+struct IsBasicString : std::false_type {};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct IsBasicString<std::basic_string<CharT, Traits, Alloc>> : std::true_type {};
+
+template <typename A, typename B, typename = void>
+struct HasCompareMember : std::false_type {};
+
+template <typename A, typename B>
+struct HasCompareMember<
+	A, B, std::void_t<decltype(std::declval<const A&>().compare(std::declval<const B&>()))>>
+	: std::true_type {};
+
+// 节点中的前缀字段，只有启用了 KeyPrefix 的键类型才占用空间
+template <typename K, bool = KeyPrefix<K>::kEnabled>
+struct NodeKeyPrefix {
+	void setKeyPrefix(const K& /*key*/) {}
+};
+
+template <typename K>
+struct NodeKeyPrefix<K, true> {
+	std::uint64_t keyPrefix = 0;
+
+	void setKeyPrefix(const K& key) {
+		keyPrefix = KeyPrefix<K>::make(key);
+	}
+};
+
+// 跳表内部使用的键比较：包装用户的 Compare，并在可用时先比较前缀。
+// 遍历中每个被访问的节点只调用一次 compare()：对字符串键它是真正的三路比较，
+// 一次就能同时知道"在 key 之前"还是"等于 key"；其他比较器退化为一次 comp 调用，
+// 相等性留到最后由 equivalent() 对停下的那个节点再判断一次
+template <typename K, typename Compare>
+class KeyComparator {
+private:
+	Compare comp;
+
+	static constexpr bool kAscending =
+		std::is_same_v<Compare, std::less<K>> || std::is_same_v<Compare, std::less<>>;
+
+	template <typename Key>
+	static constexpr bool kUsePrefix = kAscending && HasKeyPrefix<K, Key>::value;
+
+	// 能否一次比较就得到三路结果：使用前缀，或者升序下的字符串可以直接调用 compare()
+	template <typename Key>
+	static constexpr bool kThreeWay =
+		kUsePrefix<Key> ||
+		(kAscending && IsBasicString<K>::value && HasCompareMember<K, Key>::value);
+
+public:
+	// 能否只看节点中缓存的后继键来查找 key（见 successor_keys.hpp）：缓存的编码是升序的，
+	// 因此只用于升序比较器，且查找键必须就是 K
+	template <typename Key>
+	static constexpr bool kUseSuccessorKeys =
+		kAscending && std::is_same_v<Key, K> && SuccessorKey<K>::kEnabled;
+
+	// 一次查找用到的键，前缀只在开始时计算一次
+	template <typename Key>
+	struct Probe {
+		const Key& key;
+		std::uint64_t prefix;
+	};
+
+	explicit KeyComparator(Compare c = Compare()) : comp(std::move(c)) {}
+
+	const Compare& compareObject() const {
+		return comp;
+	}
+
+	template <typename A, typename B>
+	bool less(const A& a, const B& b) const {
+		return comp(a, b);
+	}
+
+	template <typename Key>
+	Probe<Key> probe(const Key& key) const {
+		if constexpr (kUsePrefix<Key>) {
+			return Probe<Key>{key, KeyPrefix<K>::make(key)};
+		} else {
+			return Probe<Key>{key, 0};
+		}
+	}
+
+	// 节点键与查找键的比较：小于 0 表示节点在 key 之前，否则不在 key 之前。
+	// 三路比较可用时 0 表示相等、大于 0 表示在之后；不可用时只返回 -1 或 1
+	template <typename NodeT, typename Key>
+	int compare(const NodeT& node, const Probe<Key>& probe) const {
+		if constexpr (kUsePrefix<Key>) {
+			if (node.keyPrefix != probe.prefix) {
+				return node.keyPrefix < probe.prefix ? -1 : 1;
+			}
+		}
+		if constexpr (kThreeWay<Key>) {
+			return threeWay(node.key, probe.key);
+		} else {
+			return comp(node.key, probe.key) ? -1 : 1;
+		}
+	}
+
+	// compare() 结果为 order（不小于 0）的节点是否与 key 相等
+	template <typename NodeT, typename Key>
+	bool equivalent(const NodeT& node, const Probe<Key>& probe, int order) const {
+		if constexpr (kThreeWay<Key>) {
+			return order == 0;
+		} else {
+			return !comp(probe.key, node.key);
+		}
+	}
+
+	// 节点 a 的键是否在节点 b 之前
+	template <typename NodeT>
+	bool nodeLess(const NodeT& a, const NodeT& b) const {
+		if constexpr (kUsePrefix<K>) {
+			if (a.keyPrefix != b.keyPrefix) {
+				return a.keyPrefix < b.keyPrefix;
+			}
+		}
+		return comp(a.key, b.key);
+	}
+
+	// 字符串在升序下直接用 compare() 一次得到结果；其他情况（自定义前缀的键）由 Compare 推出
+	template <typename A, typename B>
+	int threeWay(const A& a, const B& b) const {
+		if constexpr (kAscending && IsBasicString<A>::value && HasCompareMember<A, B>::value) {
+			return a.compare(b);
+		} else {
+			if (comp(a, b)) {
+				return -1;
+			}
+			return comp(b, a) ? 1 : 0;
+		}
+	}
+};
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // KEY_COMPARE_HPP
@@ -0,0 +1,104 @@
+#ifndef LEVEL_GENERATOR_HPP
+#define LEVEL_GENERATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace skiplist {
+
+namespace detail {
+
+// SplitMix64：一次加法加一次 xorshift-乘法混合，64 位输出每一位的质量都足够好，
+// 可以直接拿低位数尾零
+class SplitMix64 {
+private:
+	std::uint64_t state;
+
+public:
+	explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+	std::uint64_t next() {
+		std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+};
+
+// 每个线程一个生成器，不同线程、不同跳表之间没有共享状态，也不需要任何同步
+inline SplitMix64& threadGenerator() {
+	static std::atomic<std::uint64_t> sequence{0};
+	thread_local SplitMix64 generator([] {
+		// 线程序号保证各线程的种子互不相同，时钟让不同进程的序列不同
+		SplitMix64 mixer(sequence.fetch_add(1, std::memory_order_relaxed));
+		auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+		return mixer.next() ^ static_cast<std::uint64_t>(now);
+	}());
+	return generator;
+}
+
+// x 不能为 0
+inline int countTrailingZeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int count = 0;
+	while ((x & 1) == 0) {
+		x >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+// 按概率 p 逐层晋升的随机层高。
+// p = 1/2^k 时只需一次 64 位抽样：尾部每连续 k 个 0 位对应升高一层，
+// 恰好以 p^i 的概率得到高度 >= i；其他 p 退化为逐层比较整数阈值
+class LevelGenerator {
+private:
+	int maxLevel;
+	int bitsPerLevel;        // p = 1/2^bitsPerLevel，为 0 表示 p 不是 2 的负整数次幂
+	std::uint64_t threshold; // 通用路径：抽样值 < threshold 的概率为 p
+
+public:
+	LevelGenerator(float p, int maxLvl) : maxLevel(maxLvl), bitsPerLevel(0), threshold(0) {
+		for (int k = 1; k <= 16; k++) {
+			if (p == std::ldexp(1.0f, -k)) {
+				bitsPerLevel = k;
+				break;
+			}
+		}
+		if (p >= 1.0f) {
+			threshold = std::numeric_limits<std::uint64_t>::max();
+		} else if (p > 0.0f) {
+			threshold = static_cast<std::uint64_t>(std::ldexp(static_cast<double>(p), 64));
+		}
+	}
+
+	int operator()() const {
+		std::uint64_t bits = threadGenerator().next();
+		if (bitsPerLevel != 0) {
+			if (bits == 0) {
+				return maxLevel;
+			}
+			return std::min(countTrailingZeros(bits) / bitsPerLevel, maxLevel);
+		}
+
+		int lvl = 0;
+		while (lvl < maxLevel && bits < threshold) {
+			lvl++;
+			bits = threadGenerator().next();
+		}
+		return lvl;
+	}
+};
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // LEVEL_GENERATOR_HPP
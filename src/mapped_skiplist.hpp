@@ -0,0 +1,565 @@
+#ifndef MAPPED_SKIPLIST_HPP
+#define MAPPED_SKIPLIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail.hpp"
+#include "serializer.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SKIPLIST_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace skiplist {
+
+namespace detail {
+
+// 只读映射的整个文件。支持 mmap 的平台上直接映射，多个进程共享页缓存；
+// 其他平台退化为把文件读进内存
+class MappedFile {
+private:
+	const char* bytes = nullptr;
+	std::size_t length = 0;
+#ifndef SKIPLIST_HAS_MMAP
+	std::string buffer;
+#endif
+
+public:
+	MappedFile() = default;
+
+	~MappedFile() {
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path) {
+		close();
+#ifdef SKIPLIST_HAS_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat status;
+		if (::fstat(fd, &status) != 0 || status.st_size <= 0) {
+			::close(fd);
+			return false;
+		}
+		void* address =
+			::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		// 映射建立后文件描述符就不再需要
+		::close(fd);
+		if (address == MAP_FAILED) {
+			return false;
+		}
+		bytes = static_cast<const char*>(address);
+		length = static_cast<std::size_t>(status.st_size);
+		return true;
+#else
+		if (!readFile(path, buffer)) {
+			return false;
+		}
+		bytes = buffer.data();
+		length = buffer.size();
+		return true;
+#endif
+	}
+
+	void close() {
+#ifdef SKIPLIST_HAS_MMAP
+		if (bytes != nullptr) {
+			::munmap(const_cast<char*>(bytes), length);
+		}
+#else
+		buffer = std::string();
+#endif
+		bytes = nullptr;
+		length = 0;
+	}
+
+	const char* data() const {
+		return bytes;
+	}
+
+	std::size_t size() const {
+		return length;
+	}
+};
+
+// 映像中的一个元素：第 0 层的 link 是值在值区中的偏移，更高层的 link 是同一个键在下一层数组中的下标
+template <typename K>
+struct MappedEntry {
+	K key;
+	std::uint64_t link;
+};
+
+} // namespace detail
+
+// 冻结的只读跳表映像，mmap 之后直接查找，不需要反序列化。文件布局：
+//
+//   header（64 字节）：magic "SKIPMMAP" | version | sizeof(K) | 层数 | 保留 | 元素个数 |
+//                      值区偏移 | 值区长度 | 层表偏移
+//   层表：每层一项 (偏移, 元素个数)，第 0 层在前
+//   各层数组：MappedEntry<K>，每层按键有序、连续存放，起始地址按 64 字节对齐
+//   值区：按第 0 层的顺序存放 Serializer<V> 编码后的值
+//
+// 第 i 层保存第 i - 1 层中每 kFanout 个元素的最后一个，指针都换成了下标：同一层内的后继就是
+// 数组的下一项，向下一层的链接是 link。查找与 SkipList 相同：从顶层开始向右走到最后一个小于 key
+// 的元素，再沿 link 下降，每层最多前进 kFanout 步；节点在数组里相邻，顶部几层常驻缓存。
+// K 必须可平凡拷贝（直接在映射内存上比较），V 需要有 Serializer<V>，查找时解码出值的拷贝。
+// 映像只读，任意多个线程可以同时查找，不需要加锁。映像使用本机字节序，由 build() 生成
+template <typename K, typename V, typename Compare = std::less<K>>
+class MappedSkipList {
+	static_assert(std::is_trivially_copyable_v<K>,
+				  "MappedSkipList keys must be trivially copyable");
+
+public:
+	// 相邻两层的元素个数之比
+	static constexpr std::size_t kFanout = 4;
+
+private:
+	using Slot = detail::MappedEntry<K>;
+
+	struct Level {
+		const Slot* entries;
+		std::size_t size;
+	};
+
+	static constexpr char kMagic[8] = {'S', 'K', 'I', 'P', 'M', 'M', 'A', 'P'};
+	static constexpr std::uint32_t kVersion = 1;
+	static constexpr std::size_t kHeaderSize = 64;
+	static constexpr std::size_t kAlignment = 64;
+
+	detail::MappedFile file;
+	Compare comp;
+	std::vector<Level> levels; // levels[0] 为第 0 层
+	const char* values = nullptr;
+	std::size_t valuesSize = 0;
+
+	static std::size_t alignUp(std::size_t offset) {
+		return (offset + kAlignment - 1) / kAlignment * kAlignment;
+	}
+
+	// 把一个元素按内存布局追加到映像。先清零再构造，填充字节为 0，不会把未初始化的内存写进文件
+	static void appendSlot(std::string& image, const K& key, std::uint64_t link);
+
+	// 把有序的键和已编码的值写成映像文件，valueOffsets[i] 为第 i 个值在 encodedValues 中的偏移
+	static bool writeImage(const std::string& path, const std::vector<K>& keys,
+						   const std::vector<std::uint64_t>& valueOffsets,
+						   const std::string& encodedValues);
+
+	// 第一个不满足 before(key) 的元素在第 0 层的下标，before(k) 必须对一个前缀成立
+	template <typename Before>
+	std::size_t partitionPoint(Before before) const;
+
+	std::optional<V> valueAt(std::size_t index) const;
+
+public:
+	// 第 0 层上的只读迭代器，解引用得到 {key, value}。值在迭代器移动到该位置时解码，
+	// 无法解码（映像损坏）时迭代在该处结束，与 scan 相同，不会把损坏的值当作默认值返回
+	class Iterator {
+	private:
+		const MappedSkipList* owner;
+		std::size_t index;
+		std::optional<V> value;
+
+		// 解码当前位置的值，失败时跳到末尾
+		void decode() {
+			value.reset();
+			if (owner == nullptr || index >= static_cast<std::size_t>(owner->size())) {
+				return;
+			}
+			value = owner->valueAt(index);
+			if (!value.has_value()) {
+				index = static_cast<std::size_t>(owner->size());
+			}
+		}
+
+	public:
+		struct Entry {
+			const K& key;
+			V value;
+
+			const Entry* operator->() const {
+				return this;
+			}
+		};
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Entry;
+		using reference = Entry;
+
+		Iterator(const MappedSkipList* list = nullptr, std::size_t i = 0) : owner(list), index(i) {
+			decode();
+		}
+
+		reference operator*() const {
+			return Entry{owner->levels[0].entries[index].key, *value};
+		}
+
+		pointer operator->() const {
+			return **this;
+		}
+
+		Iterator& operator++() {
+			index++;
+			decode();
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		// 同一个映像中的同一位置才相等，不同映像的相同下标不相等
+		bool operator==(const Iterator& other) const {
+			return owner == other.owner && index == other.index;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+
+	explicit MappedSkipList(Compare c = Compare()) : comp(std::move(c)) {}
+
+	MappedSkipList(const MappedSkipList&) = delete;
+	MappedSkipList& operator=(const MappedSkipList&) = delete;
+
+	// 由按 Compare 严格递增的 (key, value) 序列生成映像文件，不满足递增的元素被跳过。
+	// 与 saveTo 一样先写临时文件再改名，失败返回 false
+	template <typename InputIt>
+	static bool build(const std::string& path, InputIt first, InputIt last,
+					  Compare comp = Compare());
+
+	// 由现有的跳表（SkipList、UnrolledSkipList 等提供 forEach 的容器）生成映像文件：
+	// 只在遍历期间持有它的读锁，构建各层和写文件都在锁外进行。List 的比较器必须就是 Compare
+	template <typename List>
+	static bool build(const std::string& path, const List& list);
+
+	// 映射映像文件。文件不存在、header 不符或大小不一致时返回 false，原先打开的映像会被关闭
+	bool open(const std::string& path);
+
+	void close();
+
+	bool isOpen() const {
+		return file.data() != nullptr;
+	}
+
+	std::optional<V> search(const K& key) const;
+
+	bool contains(const K& key) const;
+
+	int size() const {
+		return levels.empty() ? 0 : static_cast<int>(levels[0].size);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// 第 i 项为第 i 层的元素个数
+	std::vector<int> levelHistogram() const;
+
+	Iterator begin() const {
+		return Iterator(this, 0);
+	}
+
+	Iterator end() const {
+		return Iterator(this, levels.empty() ? 0 : levels[0].size);
+	}
+
+	Iterator lower_bound(const K& key) const;
+
+	Iterator upper_bound(const K& key) const;
+
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+};
+
+template <typename K, typename V, typename Compare>
+void MappedSkipList<K, V, Compare>::appendSlot(std::string& image, const K& key,
+											   std::uint64_t link) {
+	alignas(Slot) unsigned char bytes[sizeof(Slot)];
+	std::memset(bytes, 0, sizeof(bytes));
+	::new (static_cast<void*>(bytes)) Slot{key, link};
+	image.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+template <typename K, typename V, typename Compare>
+bool MappedSkipList<K, V, Compare>::writeImage(const std::string& path, const std::vector<K>& keys,
+											   const std::vector<std::uint64_t>& valueOffsets,
+											   const std::string& encodedValues) {
+	// 自底向上生成各层：第 i 层取第 i - 1 层中下标为 kFanout - 1, 2 * kFanout - 1, ... 的元素
+	std::vector<std::vector<Slot>> built(1);
+	built[0].reserve(keys.size());
+	for (std::size_t i = 0; i < keys.size(); i++) {
+		built[0].push_back(Slot{keys[i], valueOffsets[i]});
+	}
+	while (built.back().size() >= kFanout) {
+		const std::vector<Slot>& below = built.back();
+		std::vector<Slot> level;
+		level.reserve(below.size() / kFanout);
+		for (std::size_t i = kFanout - 1; i < below.size(); i += kFanout) {
+			level.push_back(Slot{below[i].key, i});
+		}
+		built.push_back(std::move(level));
+	}
+
+	std::size_t tableOffset = kHeaderSize;
+	std::size_t offset = alignUp(tableOffset + built.size() * 2 * sizeof(std::uint64_t));
+	std::string image(offset, '\0');
+	for (std::size_t i = 0; i < built.size(); i++) {
+		std::string table;
+		Serializer<std::uint64_t>::write(table, offset);
+		Serializer<std::uint64_t>::write(table, built[i].size());
+		image.replace(tableOffset + i * table.size(), table.size(), table);
+
+		for (const Slot& slot : built[i]) {
+			appendSlot(image, slot.key, slot.link);
+		}
+		offset = alignUp(image.size());
+		image.resize(offset, '\0');
+	}
+	std::size_t valuesOffset = image.size();
+
+	std::string header(kMagic, sizeof(kMagic));
+	Serializer<std::uint32_t>::write(header, kVersion);
+	Serializer<std::uint32_t>::write(header, static_cast<std::uint32_t>(sizeof(K)));
+	Serializer<std::uint32_t>::write(header, static_cast<std::uint32_t>(built.size()));
+	Serializer<std::uint32_t>::write(header, 0);
+	Serializer<std::uint64_t>::write(header, keys.size());
+	Serializer<std::uint64_t>::write(header, valuesOffset);
+	Serializer<std::uint64_t>::write(header, encodedValues.size());
+	Serializer<std::uint64_t>::write(header, tableOffset);
+	image.replace(0, header.size(), header);
+
+	return detail::writeFileAtomically(path, {image, encodedValues});
+}
+
+template <typename K, typename V, typename Compare>
+template <typename InputIt>
+bool MappedSkipList<K, V, Compare>::build(const std::string& path, InputIt first, InputIt last,
+										  Compare comp) {
+	std::vector<K> keys;
+	std::vector<std::uint64_t> valueOffsets;
+	std::string encodedValues;
+	for (; first != last; ++first) {
+		const auto& entry = *first;
+		if (!keys.empty() && !comp(keys.back(), entry.first)) {
+			continue; // 不满足严格递增
+		}
+		keys.push_back(entry.first);
+		valueOffsets.push_back(encodedValues.size());
+		Serializer<V>::write(encodedValues, entry.second);
+	}
+	return writeImage(path, keys, valueOffsets, encodedValues);
+}
+
+template <typename K, typename V, typename Compare>
+template <typename List>
+bool MappedSkipList<K, V, Compare>::build(const std::string& path, const List& list) {
+	// 映像按 list 的顺序存放，用另一种顺序查找会得到错误的结果
+	static_assert(std::is_same_v<std::decay_t<decltype(list.key_comp())>, Compare>,
+				  "the source list must be ordered by the same Compare as the MappedSkipList");
+	std::vector<K> keys;
+	std::vector<std::uint64_t> valueOffsets;
+	std::string encodedValues;
+	keys.reserve(static_cast<std::size_t>(list.size()));
+	valueOffsets.reserve(static_cast<std::size_t>(list.size()));
+	list.forEach([&](const K& key, const V& value) {
+		keys.push_back(key);
+		valueOffsets.push_back(encodedValues.size());
+		Serializer<V>::write(encodedValues, value);
+	});
+	return writeImage(path, keys, valueOffsets, encodedValues);
+}
+
+template <typename K, typename V, typename Compare>
+bool MappedSkipList<K, V, Compare>::open(const std::string& path) {
+	close();
+	if (!file.open(path)) {
+		return false;
+	}
+
+	const char* base = file.data();
+	const char* end = base + file.size();
+	const char* cursor = base;
+	std::uint32_t version = 0;
+	std::uint32_t keySize = 0;
+	std::uint32_t levelCount = 0;
+	std::uint32_t reserved = 0;
+	std::uint64_t count = 0;
+	std::uint64_t valuesOffset = 0;
+	std::uint64_t valuesLength = 0;
+	std::uint64_t tableOffset = 0;
+	bool valid = file.size() >= kHeaderSize && std::memcmp(base, kMagic, sizeof(kMagic)) == 0;
+	if (valid) {
+		cursor += sizeof(kMagic);
+		Serializer<std::uint32_t>::read(cursor, end, version);
+		Serializer<std::uint32_t>::read(cursor, end, keySize);
+		Serializer<std::uint32_t>::read(cursor, end, levelCount);
+		Serializer<std::uint32_t>::read(cursor, end, reserved);
+		Serializer<std::uint64_t>::read(cursor, end, count);
+		Serializer<std::uint64_t>::read(cursor, end, valuesOffset);
+		Serializer<std::uint64_t>::read(cursor, end, valuesLength);
+		Serializer<std::uint64_t>::read(cursor, end, tableOffset);
+		// 偏移来自文件，先确认不超过文件大小再做减法，避免相加溢出
+		valid = version == kVersion && keySize == sizeof(K) && levelCount >= 1 &&
+				tableOffset <= file.size() &&
+				levelCount <= (file.size() - tableOffset) / (2 * sizeof(std::uint64_t)) &&
+				valuesOffset <= file.size() && valuesLength == file.size() - valuesOffset;
+	}
+
+	// 逐层检查数组落在文件内、对齐正确，且每层不多于下一层。指针只在 header 校验通过后才形成
+	if (valid) {
+		cursor = base + tableOffset;
+	}
+	for (std::uint32_t i = 0; valid && i < levelCount; i++) {
+		std::uint64_t offset = 0;
+		std::uint64_t length = 0;
+		Serializer<std::uint64_t>::read(cursor, end, offset);
+		Serializer<std::uint64_t>::read(cursor, end, length);
+		valid = offset % alignof(Slot) == 0 && offset <= valuesOffset &&
+				length <= (valuesOffset - offset) / sizeof(Slot) &&
+				(i == 0 ? length == count : length <= levels.back().size);
+		if (valid) {
+			levels.push_back(Level{reinterpret_cast<const Slot*>(base + offset),
+								   static_cast<std::size_t>(length)});
+		}
+	}
+
+	if (!valid) {
+		close();
+		return false;
+	}
+	values = base + valuesOffset;
+	valuesSize = static_cast<std::size_t>(valuesLength);
+	return true;
+}
+
+template <typename K, typename V, typename Compare>
+void MappedSkipList<K, V, Compare>::close() {
+	levels.clear();
+	values = nullptr;
+	valuesSize = 0;
+	file.close();
+}
+
+template <typename K, typename V, typename Compare>
+template <typename Before>
+std::size_t MappedSkipList<K, V, Compare>::partitionPoint(Before before) const {
+	if (levels.empty()) {
+		return 0;
+	}
+
+	// begin 之前的元素都满足 before。每层从 begin 向右走，再由前一个元素的 link 进入下一层
+	std::size_t begin = 0;
+	for (std::size_t i = levels.size(); i-- > 0;) {
+		const Level& level = levels[i];
+		while (begin < level.size && before(level.entries[begin].key)) {
+			begin++;
+		}
+		if (i > 0 && begin > 0) {
+			// link 来自文件，越界时按损坏处理，退回整层查找
+			std::uint64_t below = level.entries[begin - 1].link;
+			begin = below < levels[i - 1].size ? static_cast<std::size_t>(below) + 1 : 0;
+		}
+	}
+	return begin;
+}
+
+template <typename K, typename V, typename Compare>
+std::optional<V> MappedSkipList<K, V, Compare>::valueAt(std::size_t index) const {
+	std::uint64_t offset = levels[0].entries[index].link;
+	if (offset > valuesSize) {
+		return std::nullopt;
+	}
+	const char* cursor = values + offset;
+	V value{};
+	if (!Serializer<V>::read(cursor, values + valuesSize, value)) {
+		return std::nullopt;
+	}
+	return value;
+}
+
+template <typename K, typename V, typename Compare>
+std::optional<V> MappedSkipList<K, V, Compare>::search(const K& key) const {
+	std::size_t index = partitionPoint([this, &key](const K& k) { return comp(k, key); });
+	if (index < static_cast<std::size_t>(size()) && !comp(key, levels[0].entries[index].key)) {
+		return valueAt(index);
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare>
+bool MappedSkipList<K, V, Compare>::contains(const K& key) const {
+	std::size_t index = partitionPoint([this, &key](const K& k) { return comp(k, key); });
+	return index < static_cast<std::size_t>(size()) && !comp(key, levels[0].entries[index].key);
+}
+
+template <typename K, typename V, typename Compare>
+std::vector<int> MappedSkipList<K, V, Compare>::levelHistogram() const {
+	std::vector<int> histogram;
+	for (const Level& level : levels) {
+		histogram.push_back(static_cast<int>(level.size));
+	}
+	return histogram;
+}
+
+template <typename K, typename V, typename Compare>
+typename MappedSkipList<K, V, Compare>::Iterator
+MappedSkipList<K, V, Compare>::lower_bound(const K& key) const {
+	return Iterator(this, partitionPoint([this, &key](const K& k) { return comp(k, key); }));
+}
+
+template <typename K, typename V, typename Compare>
+typename MappedSkipList<K, V, Compare>::Iterator
+MappedSkipList<K, V, Compare>::upper_bound(const K& key) const {
+	return Iterator(this, partitionPoint([this, &key](const K& k) { return !comp(key, k); }));
+}
+
+template <typename K, typename V, typename Compare>
+template <typename Callback>
+std::size_t MappedSkipList<K, V, Compare>::scan(const K& lo, const K& hi,
+												Callback&& callback) const {
+	std::size_t visited = 0;
+	std::size_t count = static_cast<std::size_t>(size());
+	for (std::size_t i = partitionPoint([this, &lo](const K& k) { return comp(k, lo); });
+		 i < count && comp(levels[0].entries[i].key, hi); i++) {
+		visited++;
+		std::optional<V> value = valueAt(i);
+		if (!value.has_value() || !detail::invokeScanCallback(callback, levels[0].entries[i].key,
+															   *value)) {
+			break;
+		}
+	}
+	return visited;
+}
+
+} // namespace skiplist
+
+#endif // MAPPED_SKIPLIST_HPP
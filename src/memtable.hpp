@@ -0,0 +1,211 @@
+#ifndef MEMTABLE_HPP
+#define MEMTABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "allocator.hpp"
+#include "key_compare.hpp"
+#include "node.hpp"
+#include "skiplist.hpp"
+
+namespace skiplist {
+
+// 记录的类型：普通的值，或者表示删除的墓碑
+enum class ValueType : std::uint8_t {
+	Deletion = 0,
+	Value = 1,
+};
+
+// 内部键：用户键 + 写入时的序号。同一个用户键的多个版本按序号从新到旧排列
+template <typename K>
+struct InternalKey {
+	K userKey;
+	std::uint64_t sequence;
+	ValueType type;
+};
+
+// 点查用的查找键：引用调用者的用户键，不拷贝（对字符串键省去一次堆分配）
+template <typename K>
+struct InternalLookupKey {
+	const K& userKey;
+	std::uint64_t sequence;
+};
+
+// 内部键的顺序：先按用户键升序（使用用户的比较器），用户键相同时序号大（更新）的在前。
+// 因此 lower_bound({key, S}) 直接落在该键序号不超过 S 的最新版本上。
+// 比较器是透明的，InternalKey 可以直接与 InternalLookupKey 比较
+template <typename Compare>
+struct InternalKeyCompare {
+	using is_transparent = void;
+
+	Compare userComparator;
+
+	template <typename K>
+	bool operator()(const InternalKey<K>& a, const InternalKey<K>& b) const {
+		return less(a, b);
+	}
+
+	template <typename K>
+	bool operator()(const InternalKey<K>& a, const InternalLookupKey<K>& b) const {
+		return less(a, b);
+	}
+
+	template <typename K>
+	bool operator()(const InternalLookupKey<K>& a, const InternalKey<K>& b) const {
+		return less(a, b);
+	}
+
+private:
+	template <typename A, typename B>
+	bool less(const A& a, const B& b) const {
+		if (userComparator(a.userKey, b.userKey)) {
+			return true;
+		}
+		if (userComparator(b.userKey, a.userKey)) {
+			return false;
+		}
+		return a.sequence > b.sequence;
+	}
+};
+
+namespace detail {
+
+// 键和值在节点之外占用的堆内存，用于估算 MemTable 的大小
+template <typename T>
+std::size_t externalBytes(const T& value) {
+	if constexpr (IsBasicString<T>::value) {
+		return value.capacity() * sizeof(typename T::value_type);
+	} else {
+		(void)value;
+		return 0;
+	}
+}
+
+} // namespace detail
+
+// LSM 树的内存表（与 LevelDB/RocksDB 的 memtable 相同）：只追加、不修改。
+// 每次写入都以 (用户键, 序号) 为键插入一个新节点，删除写入墓碑，旧版本保留到整张表刷到磁盘为止，
+// 因此读者可以按任意快照序号读取。序号由调用方分配，同一个键的序号不能重复。
+// 底层是 SkipList<InternalKey<K>, V>，默认使用 ArenaAllocator：表从不删除节点，整体一次释放。
+// 写入互斥、读取并发，与 SkipList 相同
+template <typename K, typename V, typename Compare = std::less<K>,
+		  typename Alloc = ArenaAllocator, int MaxLevel = 32>
+class MemTable {
+public:
+	using Key = InternalKey<K>;
+	using Table = SkipList<Key, V, InternalKeyCompare<Compare>, Alloc, MaxLevel>;
+	using Iterator = typename Table::Iterator;
+
+	// 读取最新版本时使用的快照序号
+	static constexpr std::uint64_t kMaxSequence = std::numeric_limits<std::uint64_t>::max();
+
+private:
+	Table table;
+	Compare userComparator;
+	std::atomic<std::size_t> memoryUsage{0};
+
+public:
+	explicit MemTable(int maxLvl = MaxLevel, float prob = 0.5, Alloc alloc = Alloc(),
+					  Compare comp = Compare())
+		: table(maxLvl, prob, std::move(alloc), InternalKeyCompare<Compare>{comp}),
+		  userComparator(comp) {}
+
+	MemTable(const MemTable&) = delete;
+	MemTable& operator=(const MemTable&) = delete;
+
+	// 写入一条记录，type 为 Deletion 时 value 被忽略。(key, sequence) 已存在时返回 false
+	bool add(std::uint64_t sequence, ValueType type, const K& key, const V& value);
+
+	bool put(std::uint64_t sequence, const K& key, const V& value) {
+		return add(sequence, ValueType::Value, key, value);
+	}
+
+	// 写入墓碑，使快照序号不小于 sequence 的读取看不到该键更早的版本
+	bool remove(std::uint64_t sequence, const K& key) {
+		return add(sequence, ValueType::Deletion, key, V{});
+	}
+
+	// 查找 key 在快照 snapshot 时的状态：序号不超过 snapshot 的最新版本。
+	// 返回 false 表示本表中没有可见的记录，需要继续查找更旧的数据（例如磁盘上的 SSTable）；
+	// 返回 true 时 value 为该版本的值，版本为墓碑时 value 为 std::nullopt，表示键已被删除
+	bool get(const K& key, std::uint64_t snapshot, std::optional<V>& value) const;
+
+	// 读取最新版本，键不存在或已删除时返回 std::nullopt
+	std::optional<V> get(const K& key) const {
+		std::optional<V> value;
+		get(key, kMaxSequence, value);
+		return value;
+	}
+
+	// 刷盘用的有序遍历：按内部键的顺序访问全部记录（包括旧版本和墓碑），回调参数为 (InternalKey, V)。
+	// 遍历期间持有读锁
+	template <typename Callback>
+	std::size_t forEach(Callback&& callback) const {
+		return table.forEach(std::forward<Callback>(callback));
+	}
+
+	// 与 forEach 顺序相同的迭代器。迭代器不持有锁，通常在表转为只读之后用于生成 SSTable
+	Iterator begin() const {
+		return table.begin();
+	}
+
+	Iterator end() const {
+		return table.end();
+	}
+
+	// 记录数（包括旧版本和墓碑）
+	int size() const {
+		return table.size();
+	}
+
+	bool empty() const {
+		return table.empty();
+	}
+
+	// 估算的内存占用（节点加上字符串等外部分配），用于决定何时切换到新的 MemTable
+	std::size_t approximateMemoryUsage() const {
+		return memoryUsage.load(std::memory_order_relaxed);
+	}
+};
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool MemTable<K, V, Compare, Alloc, MaxLevel>::add(std::uint64_t sequence, ValueType type,
+												   const K& key, const V& value) {
+	bool inserted = type == ValueType::Value ? table.insert(Key{key, sequence, type}, value)
+											 : table.try_emplace(Key{key, sequence, type});
+	if (inserted) {
+		// 节点高度由跳表内部决定，这里按 p = 0.5 时的平均高度（多一个指针）估算
+		std::size_t bytes = Node<Key, V>::allocationSize(1) + detail::externalBytes(key);
+		if (type == ValueType::Value) {
+			bytes += detail::externalBytes(value);
+		}
+		memoryUsage.fetch_add(bytes, std::memory_order_relaxed);
+	}
+	return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool MemTable<K, V, Compare, Alloc, MaxLevel>::get(const K& key, std::uint64_t snapshot,
+												   std::optional<V>& value) const {
+	// 表中的节点从不删除，定位之后不持有锁读取该节点是安全的
+	Iterator it = table.lower_bound(InternalLookupKey<K>{key, snapshot});
+	if (it == table.end() || userComparator(key, it->key.userKey)) {
+		return false;
+	}
+	if (it->key.type == ValueType::Deletion) {
+		value = std::nullopt;
+	} else {
+		value = it->value;
+	}
+	return true;
+}
+
+} // namespace skiplist
+
+#endif // MEMTABLE_HPP
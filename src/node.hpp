@@ -1,15 +1,257 @@
-#include <vector>
+#ifndef NODE_HPP
+#define NODE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "key_compare.hpp"
+#include "successor_keys.hpp"
 
 namespace skiplist {
 
+// 节点与它的 forward 指针塔放在同一块内存里：forward 声明长度为 1，
+// 分配时按层数在结构体尾部多申请 level 个指针（与 LevelDB 的 Node 相同的做法）。
+// 这样每次插入只需一次堆分配，遍历时访问 forward[i] 也不必再跳转到另一块内存。
+// 节点只能通过 create()/destroy() 借助分配器创建和释放（见 allocator.hpp）。
+// 键类型启用了 KeyPrefix 时，节点还从基类继承一个 keyPrefix 字段（见 key_compare.hpp）。
+// 32/64 位整数键的节点在 forward 塔之后紧接着保存各层后继的键（见 successor_keys.hpp），
+// 因此修改 forward 必须通过 setForward()。
 template <typename K, typename V>
-class Node {
+class Node : public detail::NodeKeyPrefix<K> {
 public:
+	static constexpr bool kSuccessorKeys = detail::SuccessorKey<K>::kEnabled;
+
 	K key;
 	V value;
-	std::vector<Node<K, V>*> forward;
+	int level;
+	Node<K, V>* forward[1];
+
+	static std::size_t allocationSize(int level) {
+		std::size_t size = sizeof(Node) + sizeof(Node*) * level;
+		if constexpr (kSuccessorKeys) {
+			size += sizeof(typename detail::SuccessorKey<K>::Code) * (level + 1);
+		}
+		return size;
+	}
+
+	// 键由 keyArg 构造，值由 valueArgs 原地构造（不传时值初始化），不产生多余的拷贝
+	template <typename Alloc, typename KeyArg, typename... ValueArgs>
+	static Node* create(Alloc& allocator, int level, KeyArg&& keyArg, ValueArgs&&... valueArgs) {
+		void* memory = allocator.allocate(allocationSize(level), level);
+		try {
+			return new (memory) Node(level, std::forward<KeyArg>(keyArg),
+									 std::forward<ValueArgs>(valueArgs)...);
+		} catch (...) {
+			allocator.deallocate(memory, allocationSize(level), level);
+			throw;
+		}
+	}
+
+	template <typename Alloc>
+	static void destroy(Alloc& allocator, Node* node) {
+		int level = node->level;
+		node->~Node();
+		allocator.deallocate(node, allocationSize(level), level);
+	}
+
+	void setForward(int i, Node* next) {
+		forward[i] = next;
+		if constexpr (kSuccessorKeys) {
+			using Traits = detail::SuccessorKey<K>;
+			successorKeys()[i] = next != nullptr ? Traits::encode(next->key) : Traits::kNone;
+		}
+	}
+
+	// 第 i 项为 forward[i] 的键的编码，共 level + 1 项。只对启用了后继键缓存的键类型有效。
+	// 调用者已经知道节点高度时传入 knownLevel，省去一次依赖于 level 字段的读取
+	const auto* successorKeys(int knownLevel) const {
+		using Code = typename detail::SuccessorKey<K>::Code;
+		return reinterpret_cast<const Code*>(forward + knownLevel + 1);
+	}
+
+	const auto* successorKeys() const {
+		return successorKeys(level);
+	}
+
+	auto* successorKeys() {
+		using Code = typename detail::SuccessorKey<K>::Code;
+		return reinterpret_cast<Code*>(forward + level + 1);
+	}
+
+private:
+	template <typename KeyArg, typename... ValueArgs>
+	Node(int lvl, KeyArg&& keyArg, ValueArgs&&... valueArgs)
+		: key(std::forward<KeyArg>(keyArg)), value(std::forward<ValueArgs>(valueArgs)...),
+		  level(lvl) {
+		this->setKeyPrefix(key);
+		for (int i = 0; i <= lvl; i++) {
+			setForward(i, nullptr);
+		}
+	}
+};
 
-	Node(K k, V v, int level) : key(k), value(v), forward(level + 1, nullptr) {}
+// 展开跳表（UnrolledSkipList）的块：一个块按序保存最多 Capacity 个键值，
+// 键与值分别连续存放，块内查找只需扫描 keys 数组；索引层的 forward 指针指向块，
+// 同样内联在尾部。键和值的槽位在创建时全部默认构造，因此要求 K、V 可默认构造
+template <typename K, typename V, int Capacity>
+class UnrolledNode {
+public:
+	int count; // 有效元素个数，keys[0..count) 有序
+	int level;
+	K keys[Capacity];
+	V values[Capacity];
+	UnrolledNode* forward[1];
+
+	static std::size_t allocationSize(int level) {
+		return sizeof(UnrolledNode) + sizeof(UnrolledNode*) * level;
+	}
+
+	template <typename Alloc>
+	static UnrolledNode* create(Alloc& allocator, int level) {
+		void* memory = allocator.allocate(allocationSize(level), level);
+		try {
+			return new (memory) UnrolledNode(level);
+		} catch (...) {
+			allocator.deallocate(memory, allocationSize(level), level);
+			throw;
+		}
+	}
+
+	template <typename Alloc>
+	static void destroy(Alloc& allocator, UnrolledNode* node) {
+		int level = node->level;
+		node->~UnrolledNode();
+		allocator.deallocate(node, allocationSize(level), level);
+	}
+
+private:
+	explicit UnrolledNode(int lvl) : count(0), level(lvl) {
+		for (int i = 0; i <= lvl; i++) {
+			forward[i] = nullptr;
+		}
+	}
+};
+
+// 无锁跳表节点：每层 forward 链接是一个原子的"带标记指针"，
+// 指针最低位为 1 表示该节点在这一层已被逻辑删除（Harris 标记）。
+// forward 同样内联在节点尾部。
+template <typename K, typename V>
+class ConcurrentNode {
+public:
+	using Link = std::atomic<std::uintptr_t>;
+
+	static constexpr std::uintptr_t kMarkBit = 1;
+
+	const K key;
+	const V value;
+	const int level;
+	// 插入者完成链接、删除者完成摘除各投一票，票数归零时节点才真正不可达
+	std::atomic<int> pendingUnlinks;
+	Link forward[1];
+
+	static std::size_t allocationSize(int level) {
+		return sizeof(ConcurrentNode) + sizeof(Link) * level;
+	}
+
+	static ConcurrentNode* create(const K& k, const V& v, int level) {
+		void* memory = ::operator new(allocationSize(level));
+		return new (memory) ConcurrentNode(k, v, level);
+	}
+
+	static void destroy(ConcurrentNode* node) {
+		node->~ConcurrentNode();
+		::operator delete(node);
+	}
+
+	static ConcurrentNode* pointer(std::uintptr_t link) {
+		return reinterpret_cast<ConcurrentNode*>(link & ~kMarkBit);
+	}
+
+	static bool marked(std::uintptr_t link) {
+		return (link & kMarkBit) != 0;
+	}
+
+	static std::uintptr_t pack(ConcurrentNode* node, bool mark = false) {
+		return reinterpret_cast<std::uintptr_t>(node) | (mark ? kMarkBit : 0);
+	}
+
+private:
+	ConcurrentNode(const K& k, const V& v, int lvl)
+		: key(k), value(v), level(lvl), pendingUnlinks(2), forward{0} {
+		// 尾部多分配的原子链接需要逐个构造
+		for (int i = 1; i <= lvl; i++) {
+			new (&forward[i]) Link(0);
+		}
+	}
+};
+
+namespace detail {
+
+// 节点内的自旋锁，只占一个字节。临界区只有几次指针读写，自旋比挂起线程便宜；
+// 等待时只读不写（test-and-test-and-set），避免在锁所在的缓存行上来回争抢
+class SpinLock {
+private:
+	std::atomic<bool> locked{false};
+
+public:
+	void lock() {
+		while (locked.exchange(true, std::memory_order_acquire)) {
+			while (locked.load(std::memory_order_relaxed)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void unlock() {
+		locked.store(false, std::memory_order_release);
+	}
+};
+
+} // namespace detail
+
+// 细粒度锁跳表（FineGrainedSkipList）的节点：每个节点带一把自旋锁，forward 为原子指针，
+// 写者在锁内修改，读者不加锁直接读取。marked 表示已被逻辑删除，fullyLinked 表示所有层都已链接，
+// 两者都只会从 false 变为 true。forward 同样内联在节点尾部
+template <typename K, typename V>
+class LockedNode {
+public:
+	using Link = std::atomic<LockedNode*>;
+
+	const K key;
+	const V value;
+	const int level;
+	detail::SpinLock lock;
+	std::atomic<bool> marked;
+	std::atomic<bool> fullyLinked;
+	Link forward[1];
+
+	static std::size_t allocationSize(int level) {
+		return sizeof(LockedNode) + sizeof(Link) * level;
+	}
+
+	static LockedNode* create(const K& k, const V& v, int level) {
+		void* memory = ::operator new(allocationSize(level));
+		return new (memory) LockedNode(k, v, level);
+	}
+
+	static void destroy(LockedNode* node) {
+		node->~LockedNode();
+		::operator delete(node);
+	}
+
+private:
+	LockedNode(const K& k, const V& v, int lvl)
+		: key(k), value(v), level(lvl), marked(false), fullyLinked(false), forward{nullptr} {
+		for (int i = 1; i <= lvl; i++) {
+			new (&forward[i]) Link(nullptr);
+		}
+	}
 };
 
 } // namespace skiplist
+
+#endif // NODE_HPP
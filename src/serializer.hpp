@@ -0,0 +1,348 @@
+#ifndef SERIALIZER_HPP
+#define SERIALIZER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SKIPLIST_HAS_FSYNC 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace skiplist {
+
+// 快照文件中键和值的编码扩展点。特化 Serializer<T> 并提供
+//
+//   static void write(std::string& out, const T& value);               // 追加到 out 末尾
+//   static bool read(const char*& cursor, const char* end, T& value);  // 成功时前移 cursor
+//
+// 就可以保存该类型。read 遇到截断或非法数据时返回 false。
+// 自带的实现覆盖可平凡拷贝的类型（按本机字节序原样保存）和 std::basic_string（变长长度 + 字符）
+template <typename T, typename = void>
+struct Serializer;
+
+template <typename T>
+struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>>> {
+	static void write(std::string& out, const T& value) {
+		out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	static bool read(const char*& cursor, const char* end, T& value) {
+		if (static_cast<std::size_t>(end - cursor) < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+	}
+};
+
+namespace detail {
+
+// LEB128 变长整数：每字节 7 位，最高位表示后面还有字节
+inline void writeVarint(std::string& out, std::uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back(static_cast<char>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<char>(value));
+}
+
+inline bool readVarint(const char*& cursor, const char* end, std::uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && cursor != end; shift += 7) {
+		auto byte = static_cast<unsigned char>(*cursor++);
+		value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace detail
+
+template <typename CharT, typename Traits, typename Alloc>
+struct Serializer<std::basic_string<CharT, Traits, Alloc>> {
+	static_assert(std::is_trivially_copyable_v<CharT>, "CharT must be trivially copyable");
+
+	static void write(std::string& out, const std::basic_string<CharT, Traits, Alloc>& value) {
+		detail::writeVarint(out, value.size());
+		out.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(CharT));
+	}
+
+	static bool read(const char*& cursor, const char* end,
+					 std::basic_string<CharT, Traits, Alloc>& value) {
+		std::uint64_t length = 0;
+		if (!detail::readVarint(cursor, end, length) ||
+			length > static_cast<std::uint64_t>(end - cursor) / sizeof(CharT)) {
+			return false;
+		}
+		value.resize(static_cast<std::size_t>(length));
+		std::memcpy(&value[0], cursor, static_cast<std::size_t>(length) * sizeof(CharT));
+		cursor += length * sizeof(CharT);
+		return true;
+	}
+};
+
+namespace detail {
+
+// 快照文件格式：
+//
+//   magic "SKIPLIST"（8 字节）| version（uint32）| 保留（uint32）| count（uint64）
+//   count 个条目，每个条目为 Serializer<K>::write 之后紧跟 Serializer<V>::write
+//
+// 条目按跳表的顺序排列，整数字段使用本机字节序，不同字节序的机器之间不能互相读取
+constexpr char kSnapshotMagic[8] = {'S', 'K', 'I', 'P', 'L', 'I', 'S', 'T'};
+constexpr std::uint32_t kSnapshotVersion = 1;
+constexpr std::size_t kSnapshotHeaderSize = 8 + 4 + 4 + 8;
+
+inline std::string snapshotHeader(std::uint64_t count) {
+	std::string header(kSnapshotMagic, sizeof(kSnapshotMagic));
+	Serializer<std::uint32_t>::write(header, kSnapshotVersion);
+	Serializer<std::uint32_t>::write(header, 0);
+	Serializer<std::uint64_t>::write(header, count);
+	return header;
+}
+
+// 校验 header，成功时 cursor 指向第一个条目，count 为条目数
+inline bool parseSnapshotHeader(const char*& cursor, const char* end, std::uint64_t& count) {
+	if (static_cast<std::size_t>(end - cursor) < kSnapshotHeaderSize ||
+		std::memcmp(cursor, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+		return false;
+	}
+	cursor += sizeof(kSnapshotMagic);
+
+	std::uint32_t version = 0;
+	std::uint32_t reserved = 0;
+	Serializer<std::uint32_t>::read(cursor, end, version);
+	Serializer<std::uint32_t>::read(cursor, end, reserved);
+	Serializer<std::uint64_t>::read(cursor, end, count);
+	return version == kSnapshotVersion;
+}
+
+// 把已写入的数据落盘。不支持 fsync 的平台上只刷新 stdio 缓冲区
+inline bool syncFile(std::FILE* file) {
+	if (std::fflush(file) != 0) {
+		return false;
+	}
+#ifdef SKIPLIST_HAS_FSYNC
+	return ::fsync(::fileno(file)) == 0;
+#else
+	return true;
+#endif
+}
+
+// 把 path 所在目录的目录项（新建、改名）落盘。不支持 fsync 的平台上什么也不做
+inline bool syncParentDirectory(const std::string& path) {
+#ifdef SKIPLIST_HAS_FSYNC
+	std::string directory = std::filesystem::path(path).parent_path().string();
+	if (directory.empty()) {
+		directory = ".";
+	}
+	int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (fd < 0) {
+		return false;
+	}
+	bool ok = ::fsync(fd) == 0;
+	::close(fd);
+	return ok;
+#else
+	(void)path;
+	return true;
+#endif
+}
+
+// writeFileAtomically 的后半部分：written 表示之前的写入是否都成功，之后落盘、关闭 file 并把
+// temporary 改名为 path。失败时删除临时文件
+inline bool commitTemporaryFile(std::FILE* file, const std::string& temporary,
+								const std::string& path, bool written, bool sync) {
+	bool ok = written && (sync ? syncFile(file) : std::fflush(file) == 0);
+	ok = std::fclose(file) == 0 && ok;
+	if (!ok) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+
+	if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+		return false;
+	}
+	return !sync || syncParentDirectory(path);
+}
+
+// 依次写入 parts：先写到 path.tmp，全部写成功后再改名为 path，中途失败不会破坏已有的文件。
+// sync 为 true 时改名前 fsync 临时文件、改名后 fsync 所在目录，返回 true 时新文件在掉电后也一定完整；
+// 为 false 时只保证进程崩溃后文件要么是旧的、要么是完整的新文件
+inline bool writeFileAtomically(const std::string& path,
+								std::initializer_list<std::string_view> parts, bool sync = false) {
+	std::string temporary = path + ".tmp";
+	std::FILE* file = std::fopen(temporary.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	bool ok = true;
+	for (std::string_view part : parts) {
+		ok = ok && std::fwrite(part.data(), 1, part.size(), file) == part.size();
+	}
+	return commitTemporaryFile(file, temporary, path, ok, sync);
+}
+
+// 边遍历边写快照：条目编码到一个 kChunkSize 左右的缓冲区，攒满就写入文件，
+// 内存占用与快照大小无关。header 中的条目数先写 0，finish() 时回填。
+// 与 writeFileAtomically 一样写到 path.tmp，finish() 成功后才改名为 path；没有 finish 就析构时删除临时文件
+class SnapshotWriter {
+	static constexpr std::size_t kChunkSize = 64 * 1024;
+	static constexpr long kCountOffset = 8 + 4 + 4;
+
+	std::string path;
+	std::string temporary;
+	std::FILE* file = nullptr;
+	std::string buffer;
+	bool ok = false;
+
+	void flush() {
+		ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+		buffer.clear();
+	}
+
+public:
+	explicit SnapshotWriter(const std::string& target)
+		: path(target), temporary(target + ".tmp") {
+		file = std::fopen(temporary.c_str(), "wb");
+		ok = file != nullptr;
+		buffer.reserve(kChunkSize + kChunkSize / 4);
+		buffer.append(snapshotHeader(0));
+	}
+
+	~SnapshotWriter() {
+		if (file != nullptr) {
+			std::fclose(file);
+			std::remove(temporary.c_str());
+		}
+	}
+
+	SnapshotWriter(const SnapshotWriter&) = delete;
+	SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+	template <typename K, typename V>
+	void append(const K& key, const V& value) {
+		if (!ok) {
+			return; // 已经失败，不必再编码
+		}
+		Serializer<K>::write(buffer, key);
+		Serializer<V>::write(buffer, value);
+		if (buffer.size() >= kChunkSize) {
+			flush();
+		}
+	}
+
+	// 写出剩余的条目并回填条目数，然后落盘并改名。sync 的含义同 writeFileAtomically
+	bool finish(std::uint64_t count, bool sync) {
+		if (file == nullptr) {
+			return false;
+		}
+		flush();
+		std::string encoded;
+		Serializer<std::uint64_t>::write(encoded, count);
+		ok = ok && std::fseek(file, kCountOffset, SEEK_SET) == 0 &&
+			 std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+		std::FILE* closing = file;
+		file = nullptr;
+		return commitTemporaryFile(closing, temporary, path, ok, sync);
+	}
+};
+
+inline bool readFile(const std::string& path, std::string& contents) {
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) {
+		return false;
+	}
+	std::streamoff size = in.tellg();
+	if (size < 0) {
+		return false;
+	}
+	contents.resize(static_cast<std::size_t>(size));
+	in.seekg(0);
+	return static_cast<bool>(in.read(&contents[0], size));
+}
+
+// 分块读取并解码快照文件，不把整个文件读进内存：缓冲区中只有当前位置之后的一段，
+// 条目跨越缓冲区末尾时再读入一块（条目比一块还大时按缓冲区的大小成倍读入）。
+// 文件无法读取、数据截断、header 不符或末尾有多余字节时返回 false
+template <typename K, typename V>
+bool readSnapshot(const std::string& path, std::vector<std::pair<K, V>>& entries) {
+	constexpr std::size_t kChunkSize = 64 * 1024;
+
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) {
+		return false;
+	}
+	std::streamoff size = in.tellg();
+	if (size < 0) {
+		return false;
+	}
+	in.seekg(0);
+
+	std::string buffer;
+	std::size_t position = 0; // buffer 中尚未解码的第一个字节
+	// 丢弃已解码的部分，再从文件读入至少一块。文件已经读完时返回 false
+	auto more = [&]() {
+		buffer.erase(0, position);
+		position = 0;
+		std::size_t chunk = std::max(kChunkSize, buffer.size());
+		std::size_t old = buffer.size();
+		buffer.resize(old + chunk);
+		in.read(&buffer[old], static_cast<std::streamsize>(chunk));
+		buffer.resize(old + static_cast<std::size_t>(in.gcount()));
+		return buffer.size() > old;
+	};
+
+	while (buffer.size() < kSnapshotHeaderSize) {
+		if (!more()) {
+			return false;
+		}
+	}
+	const char* cursor = buffer.data();
+	std::uint64_t count = 0;
+	if (!parseSnapshotHeader(cursor, buffer.data() + buffer.size(), count)) {
+		return false;
+	}
+	position = kSnapshotHeaderSize;
+
+	// count 来自文件，不可信：每个条目至少占一个字节，预留的空间不超过文件大小
+	entries.clear();
+	entries.reserve(static_cast<std::size_t>(
+		std::min<std::uint64_t>(count, static_cast<std::uint64_t>(size))));
+	for (std::uint64_t i = 0; i < count;) {
+		std::pair<K, V> entry;
+		cursor = buffer.data() + position;
+		const char* end = buffer.data() + buffer.size();
+		if (Serializer<K>::read(cursor, end, entry.first) &&
+			Serializer<V>::read(cursor, end, entry.second)) {
+			position = static_cast<std::size_t>(cursor - buffer.data());
+			entries.push_back(std::move(entry));
+			i++;
+		} else if (!more()) {
+			return false;
+		}
+	}
+	return position == buffer.size() && !more();
+}
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // SERIALIZER_HPP
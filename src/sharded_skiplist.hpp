@@ -0,0 +1,360 @@
+#ifndef SHARDED_SKIPLIST_HPP
+#define SHARDED_SKIPLIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "allocator.hpp"
+#include "detail.hpp"
+#include "skiplist.hpp"
+
+namespace skiplist {
+
+// 分片跳表：把键空间划分给 N 个独立的 SkipList，每个分片有自己的读写锁，
+// 不同分片上的写入互不阻塞，写吞吐随分片数（和核数）增长。有两种划分方式：
+//
+//   按哈希：ShardedSkipList(shardCount)，键经 Hash 打散后均匀分布，适合点查/点写
+//   按范围：ShardedSkipList(splitPoints)，分片 i 保存 [splitPoints[i-1], splitPoints[i]) 内的键，
+//           分片之间本身有序，范围查询只访问相关的分片
+//
+// 两种方式都支持有序遍历：范围划分时依次遍历各个分片，哈希划分时对各分片做多路归并（每步 O(N)）。
+// 单键操作只锁一个分片。跨分片的 scan/forEach 逐个分片加读锁，看到的不是整个表同一时刻的快照
+template <typename K, typename V, typename Compare = std::less<K>, typename Hash = std::hash<K>,
+		  typename Alloc = NewDeleteAllocator, int MaxLevel = 32>
+class ShardedSkipList {
+public:
+	using List = SkipList<K, V, Compare, Alloc, MaxLevel>;
+
+	static constexpr int kDefaultShards = 16;
+
+private:
+	// 每个分片独占缓存行，避免相邻分片的锁和计数器发生伪共享
+	struct alignas(64) Shard {
+		List list;
+
+		Shard(int maxLvl, float prob, const Compare& comp) : list(maxLvl, prob, Alloc(), comp) {}
+	};
+
+	std::vector<std::unique_ptr<Shard>> shards;
+	std::vector<K> splitPoints; // 为空表示按哈希划分
+	Compare comp;
+	Hash hash;
+
+	bool ranged() const {
+		return !splitPoints.empty();
+	}
+
+	void createShards(int count, int maxLvl, float prob);
+
+	std::size_t shardIndex(const K& key) const;
+
+	List& shardFor(const K& key) {
+		return shards[shardIndex(key)]->list;
+	}
+
+	const List& shardFor(const K& key) const {
+		return shards[shardIndex(key)]->list;
+	}
+
+public:
+	// 跨分片的有序只读迭代器，解引用得到节点（it->key / it->value）。
+	// 与 SkipList::Iterator 相同，遍历期间不能有并发的 remove
+	class Iterator {
+	private:
+		using ListIterator = typename List::Iterator;
+
+		const ShardedSkipList* owner = nullptr;
+		std::vector<ListIterator> heads; // 每个分片中下一个要访问的位置
+		int current = -1;                // 当前元素所在的分片，-1 表示末尾
+
+		// 从分片 from 开始选出下一个元素：范围划分取第一个非空的分片，哈希划分取各分片中最小的键
+		void select(std::size_t from) {
+			current = -1;
+			for (std::size_t i = from; i < heads.size(); i++) {
+				if (heads[i] == owner->shards[i]->list.end()) {
+					continue;
+				}
+				if (current < 0 || owner->comp(heads[i]->key, heads[current]->key)) {
+					current = static_cast<int>(i);
+				}
+				if (owner->ranged()) {
+					break;
+				}
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Node<K, V>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Node<K, V>*;
+		using reference = const Node<K, V>&;
+
+		Iterator() = default;
+
+		Iterator(const ShardedSkipList* list, std::vector<ListIterator> positions)
+			: owner(list), heads(std::move(positions)) {
+			select(0);
+		}
+
+		reference operator*() const {
+			return *heads[current];
+		}
+
+		pointer operator->() const {
+			return &*heads[current];
+		}
+
+		Iterator& operator++() {
+			++heads[current];
+			select(owner->ranged() ? static_cast<std::size_t>(current) : 0);
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const {
+			if (current < 0 || other.current < 0) {
+				return current < 0 && other.current < 0;
+			}
+			return heads[current] == other.heads[other.current];
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+
+private:
+	// 各分片中由 seekInShard 定位起点，构造跨分片的迭代器
+	template <typename Seek>
+	Iterator seek(const K& key, Seek seekInShard) const;
+
+public:
+	// 按哈希划分为 shardCount 个分片，maxLvl/prob 用于每个分片
+	explicit ShardedSkipList(int shardCount = kDefaultShards, int maxLvl = MaxLevel,
+							 float prob = 0.5, Hash h = Hash(), Compare c = Compare())
+		: comp(std::move(c)), hash(std::move(h)) {
+		createShards(std::max(shardCount, 1), maxLvl, prob);
+	}
+
+	// 按范围划分：分片数为分界点个数 + 1。分界点会被排序，等价的分界点只保留一个
+	explicit ShardedSkipList(std::vector<K> points, int maxLvl = MaxLevel, float prob = 0.5,
+							 Compare c = Compare())
+		: splitPoints(std::move(points)), comp(std::move(c)) {
+		std::sort(splitPoints.begin(), splitPoints.end(), comp);
+		splitPoints.erase(std::unique(splitPoints.begin(), splitPoints.end(),
+									  [this](const K& a, const K& b) { return !comp(a, b); }),
+						  splitPoints.end());
+		createShards(static_cast<int>(splitPoints.size()) + 1, maxLvl, prob);
+	}
+
+	ShardedSkipList(const ShardedSkipList&) = delete;
+	ShardedSkipList& operator=(const ShardedSkipList&) = delete;
+
+	bool insert(const K& key, const V& value) {
+		return shardFor(key).insert(key, value);
+	}
+
+	template <typename... Args>
+	bool try_emplace(const K& key, Args&&... args) {
+		return shardFor(key).try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	template <typename M>
+	bool insert_or_assign(const K& key, M&& value) {
+		return shardFor(key).insert_or_assign(key, std::forward<M>(value));
+	}
+
+	bool remove(const K& key) {
+		return shardFor(key).remove(key);
+	}
+
+	std::optional<V> search(const K& key) const {
+		return shardFor(key).search(key);
+	}
+
+	bool contains(const K& key) const {
+		return shardFor(key).contains(key);
+	}
+
+	// 按分片拆开后分别调用各分片的 insertBatch，每个分片只加一次写锁
+	std::size_t insertBatch(std::vector<std::pair<K, V>> batch);
+
+	// 各分片元素数之和。并发修改时不是精确的瞬时值
+	int size() const;
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	int shardCount() const {
+		return static_cast<int>(shards.size());
+	}
+
+	// 第 i 项为分片 i 的元素个数，用于观察数据是否均匀
+	std::vector<int> shardSizes() const;
+
+	Iterator begin() const;
+
+	Iterator end() const {
+		return Iterator();
+	}
+
+	// 第一个键 >= key 的位置
+	Iterator lower_bound(const K& key) const {
+		return seek(key, [&key](const List& list) { return list.lower_bound(key); });
+	}
+
+	// 第一个键 > key 的位置
+	Iterator upper_bound(const K& key) const {
+		return seek(key, [&key](const List& list) { return list.upper_bound(key); });
+	}
+
+	// 按键升序访问 [lo, hi) 内的元素，回调规则与 SkipList::scan 相同。
+	// 范围划分时只扫描与区间相交的分片；哈希划分时每个分片都要扫描，结果拷贝出来归并后再回调
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+};
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+void ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::createShards(int count, int maxLvl,
+																		 float prob) {
+	shards.reserve(static_cast<std::size_t>(count));
+	for (int i = 0; i < count; i++) {
+		shards.push_back(std::make_unique<Shard>(maxLvl, prob, comp));
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+std::size_t
+ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::shardIndex(const K& key) const {
+	if (ranged()) {
+		return static_cast<std::size_t>(
+			std::upper_bound(splitPoints.begin(), splitPoints.end(), key, comp) -
+			splitPoints.begin());
+	}
+	// std::hash 对整数通常是恒等映射，先乘黄金比例常数打散，再用高 32 位乘法映射到 [0, N)
+	std::uint64_t mixed = static_cast<std::uint64_t>(hash(key)) * 0x9e3779b97f4a7c15ull;
+	return static_cast<std::size_t>(((mixed >> 32) * shards.size()) >> 32);
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+std::size_t ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::insertBatch(
+	std::vector<std::pair<K, V>> batch) {
+	std::vector<std::vector<std::pair<K, V>>> perShard(shards.size());
+	for (auto& entry : batch) {
+		perShard[shardIndex(entry.first)].push_back(std::move(entry));
+	}
+
+	std::size_t inserted = 0;
+	for (std::size_t i = 0; i < shards.size(); i++) {
+		if (!perShard[i].empty()) {
+			inserted += shards[i]->list.insertBatch(std::move(perShard[i]));
+		}
+	}
+	return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+int ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::size() const {
+	int total = 0;
+	for (const auto& shard : shards) {
+		total += shard->list.size();
+	}
+	return total;
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+std::vector<int> ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::shardSizes() const {
+	std::vector<int> sizes;
+	sizes.reserve(shards.size());
+	for (const auto& shard : shards) {
+		sizes.push_back(shard->list.size());
+	}
+	return sizes;
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+typename ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::Iterator
+ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::begin() const {
+	std::vector<typename List::Iterator> heads;
+	heads.reserve(shards.size());
+	for (const auto& shard : shards) {
+		heads.push_back(shard->list.begin());
+	}
+	return Iterator(this, std::move(heads));
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+template <typename Seek>
+typename ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::Iterator
+ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::seek(const K& key, Seek seekInShard) const {
+	// 范围划分时 key 所在分片之前的键都小于 key，之后的键都大于 key，只有这一个分片需要定位
+	std::size_t target = ranged() ? shardIndex(key) : 0;
+	std::vector<typename List::Iterator> heads;
+	heads.reserve(shards.size());
+	for (std::size_t i = 0; i < shards.size(); i++) {
+		const List& list = shards[i]->list;
+		if (!ranged() || i == target) {
+			heads.push_back(seekInShard(list));
+		} else {
+			heads.push_back(i < target ? list.end() : list.begin());
+		}
+	}
+	return Iterator(this, std::move(heads));
+}
+
+template <typename K, typename V, typename Compare, typename Hash, typename Alloc, int MaxLevel>
+template <typename Callback>
+std::size_t ShardedSkipList<K, V, Compare, Hash, Alloc, MaxLevel>::scan(const K& lo, const K& hi,
+																	   Callback&& callback) const {
+	std::size_t visited = 0;
+	if (ranged()) {
+		bool stopped = false;
+		auto forward = [&callback, &stopped](const K& key, const V& value) {
+			stopped = !detail::invokeScanCallback(callback, key, value);
+			return !stopped;
+		};
+		// hi 所在的分片之后不会有 < hi 的键
+		std::size_t last = std::min(shardIndex(hi), shards.size() - 1);
+		for (std::size_t i = shardIndex(lo); i <= last && !stopped; i++) {
+			visited += shards[i]->list.scan(lo, hi, forward);
+		}
+		return visited;
+	}
+
+	std::vector<std::pair<K, V>> entries;
+	for (const auto& shard : shards) {
+		shard->list.scan(lo, hi, [&entries](const K& key, const V& value) {
+			entries.emplace_back(key, value);
+		});
+	}
+	std::sort(entries.begin(), entries.end(),
+			  [this](const auto& a, const auto& b) { return comp(a.first, b.first); });
+	for (const auto& entry : entries) {
+		visited++;
+		if (!detail::invokeScanCallback(callback, entry.first, entry.second)) {
+			break;
+		}
+	}
+	return visited;
+}
+
+} // namespace skiplist
+
+#endif // SHARDED_SKIPLIST_HPP
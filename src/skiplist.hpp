@@ -1,139 +1,717 @@
 #ifndef SKIPLIST_HPP
 #define SKIPLIST_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "allocator.hpp"
+#include "detail.hpp"
+#include "key_compare.hpp"
+#include "level_generator.hpp"
 #include "node.hpp"
+#include "serializer.hpp"
+#include "span.hpp"
+#include "stats.hpp"
+
+// 调试用的跟踪钩子。默认编译为空操作，热路径上没有任何 I/O；
+// 需要时在包含本头文件之前定义，例如：
+//   #define SKIPLIST_TRACE(message) (std::clog << message << std::endl)
+#ifndef SKIPLIST_TRACE
+#define SKIPLIST_TRACE(message) ((void)0)
+#endif
 
 namespace skiplist {
 
-template <typename K, typename V>
+// Compare 为键的严格弱序，与 std::map 相同，默认按 operator< 升序；
+// 键相等由 !comp(a, b) && !comp(b, a) 判定。比较器带 is_transparent 时查找接口接受异构键。
+// Alloc 为节点分配器，默认使用 operator new/delete，也可以换成 ArenaAllocator 等（见 allocator.hpp）。
+// MaxLevel 是编译期的层数上限，各操作的前驱数组据此直接分配在栈上；
+// 构造函数中的 maxLvl 仍然有效，但不会超过 MaxLevel
+template <typename K, typename V, typename Compare = std::less<K>,
+		  typename Alloc = NewDeleteAllocator, int MaxLevel = 32>
 class SkipList {
+	static_assert(MaxLevel >= 0, "MaxLevel must be non-negative");
+
 private:
+	// 各层的前驱节点，下标为层号
+	using NodeArray = std::array<Node<K, V>*, MaxLevel + 1>;
+
 	int maxLevel;
 	float p;
+	detail::LevelGenerator levelGenerator;
+	detail::KeyComparator<K, Compare> keyComparator;
 	std::atomic<int> currentLevel; // 使用原子操作
+	Alloc allocator;
 	Node<K, V>* header;
 	mutable std::shared_mutex rw_mutex; // 读写锁，保护整个数据结构
+	// 元素个数和各高度的节点数，在写锁内随 insert/remove 增量维护，读取时无需加锁
+	std::atomic<int> elementCount;
+	std::atomic<int> heightCounts[MaxLevel + 1];
+	// 每次 remove 释放节点时加一，Finger 记录的路径只在版本号未变时可以复用。写锁内修改
+	std::uint64_t structureVersion;
+	// 运行期统计（见 stats.hpp），未定义 SKIPLIST_ENABLE_STATS 时全部为空操作
+	detail::StatsCollector<MaxLevel> statistics;
+
+	// 从顶层下降，返回第一个键不小于 key 的节点，found 表示它的键是否与 key 相等。
+	// update 不为空时记录各层的前驱。每个访问到的节点只做一次三路比较，
+	// 上一层停下时比较过的节点在下一层再次遇到时直接沿用结果。调用者需持有锁
+	template <typename Key>
+	Node<K, V>* findPosition(const Key& key, Node<K, V>** update, bool& found) const;
+
+	// 整数键的 findPosition：在当前节点缓存的后继键中数出有几层的后继小于 key（SIMD 一次比较多层），
+	// 小于的层恰好是一个前缀 [0, m)，于是直接跳到第 m - 1 层的后继，m 到顶层的前驱都是当前节点。
+	// 不前进的后继节点完全不会被访问。调用者需持有锁
+	Node<K, V>* findPositionBySuccessorKeys(const K& key, Node<K, V>** update, bool& found) const;
+
+	template <typename Key>
+	Node<K, V>* findGreaterOrEqual(const Key& key) const;
+
+	// 返回第一个键大于 key 的节点，调用者需持有锁
+	Node<K, V>* findGreaterThan(const K& key) const;
+
+	// 在 update 给出的各层前驱之后链接一个高度为 level 的新节点，键值由参数原地构造，
+	// 调用者需持有写锁。level 超过当前最高层时，update 中新增的层会被设为 header
+	template <typename KeyArg, typename... Args>
+	Node<K, V>* linkNode(Node<K, V>** update, int level, KeyArg&& key, Args&&... args);
+
+	// insert/try_emplace 的公共实现：键不存在时插入，key 为 K 的左值或右值
+	template <typename KeyArg, typename... Args>
+	bool tryEmplaceImpl(KeyArg&& key, Args&&... args);
+
+	template <typename KeyArg, typename M>
+	bool insertOrAssignImpl(KeyArg&& key, M&& value);
+
+	template <typename Key>
+	std::optional<V> searchImpl(const Key& key) const;
+
+	template <typename Key>
+	bool containsImpl(const Key& key) const;
+
+	// multiGet 中一个进行中的查找，状态与 findPosition / findPositionBySuccessorKeys 的局部变量相同。
+	// 比较器只用于 K 本身，查找键是 probe.key
+	struct PendingLookup {
+		std::size_t index; // 结果在输出中的下标
+		typename detail::KeyComparator<K, Compare>::template Probe<K> probe;
+		Node<K, V>* current;
+		Node<K, V>* stop;
+		int stopOrder;
+		int level;           // 通用路径为当前所在的层，后继键路径为参与比较的层数
+		Node<K, V>* match;   // 已经找到的节点，下一步读取它的值
+		bool finished;
+		detail::DescentTrace<MaxLevel> trace;
+	};
+
+	// 把 lookup 推进一步：一次比较之后预取下一步要读的节点就返回，让同组的其他查找接着执行。
+	// 到达第 0 层后先预取结果节点，再下一步才把值写入 results。查找完成时返回 true
+	bool stepLookup(PendingLookup& lookup, std::vector<std::optional<V>>& results) const;
+
+	// multiGet/multiPut 按排序后的键处理时，键之间平均相隔不超过这么多个元素就沿前驱路径逐个查找。
+	// 间隔大时从前驱路径出发也要经过同样多次缓存缺失，省下的只是本来就在缓存中的上层节点，
+	// 不如交错执行（multiGet）或直接从 header 下降（multiPut）
+	static constexpr std::size_t kSweepGap = 16;
+
+	// 按键排序后的下标，键相等时保持原来的先后顺序
+	template <typename T, typename KeyOf>
+	std::vector<std::size_t> sortedOrder(Span<const T> items, KeyOf keyOf) const;
+
+	// multiPut 的公共实现。Entry 为 const 时拷贝键值，否则移动
+	template <typename Entry>
+	std::vector<bool> multiPutImpl(Span<Entry> entries);
+
+	// insertBatch 的主体：batch 已按键稳定排序，调用者需持有写锁
+	std::size_t insertSortedBatch(std::vector<std::pair<K, V>>& batch);
+
+	// bulkLoad 使用的确定性层高：第 index 个元素（从 1 开始）每能被 1/p 整除一次就升高一层，
+	// 得到与随机层高分布相同、但完全均匀的塔
+	int deterministicLevel(std::size_t index) const;
+
+public:
+	class Finger;
+
+private:
+	// 从 finger 缓存的前驱路径出发定位 key：先向上爬到能跨过 key 的最低一层，再从那里下降，
+	// 代价为 O(log d)，d 为 key 与上一次查找位置之间的元素个数。
+	// 返回后 finger 中第 0..exactLevel 层为 key 的精确前驱，可以直接作为 linkNode 的 update。
+	// 返回第一个键不小于 key 的节点，found 表示它是否等于 key。调用者需持有锁
+	Node<K, V>* findWithFinger(const K& key, Finger& finger, int exactLevel, bool& found) const;
 
 public:
-	SkipList(int maxLvl, float prob = 0.5);
+	// 查找指针（finger）：保存上一次查找在各层的前驱路径。键有局部性时（如按时间递增的键），
+	// 下一次查找从这里出发，只需爬升/下降 O(log d) 层，而不必每次从 header 的顶层开始。
+	// Finger 由调用者持有，不是线程安全的，每个线程应使用自己的 Finger；
+	// 任何 remove 都会使已记录的路径失效（其中的节点可能已被释放），下一次使用时自动从 header 开始。
+	class Finger {
+	private:
+		friend class SkipList;
+
+		const SkipList* owner = nullptr;
+		std::uint64_t version = 0;
+		int height = -1; // path[0..height] 有效
+		NodeArray path;
+
+	public:
+		Finger() = default;
+
+		// 丢弃缓存的路径，下一次查找从 header 开始
+		void reset() {
+			owner = nullptr;
+		}
+	};
+
+	// 沿第 0 层前进的只读前向迭代器，解引用得到节点（通过 it->key / it->value 访问）。
+	// 迭代器本身不持有锁：只在定位起点时加读锁，之后的遍历要求没有并发的 remove，
+	// 否则迭代器可能悬空。需要与写线程并发遍历时请使用 scan()。
+	class Iterator {
+	private:
+		const Node<K, V>* node;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Node<K, V>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Node<K, V>*;
+		using reference = const Node<K, V>&;
+
+		explicit Iterator(const Node<K, V>* n = nullptr) : node(n) {}
+
+		reference operator*() const {
+			return *node;
+		}
+
+		pointer operator->() const {
+			return node;
+		}
+
+		Iterator& operator++() {
+			node = node->forward[0];
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator previous = *this;
+			node = node->forward[0];
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return node == other.node;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return node != other.node;
+		}
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+
+	explicit SkipList(int maxLvl = MaxLevel, float prob = 0.5, Alloc alloc = Alloc(),
+					  Compare comp = Compare());
 	~SkipList();
 
+	SkipList(const SkipList&) = delete;
+	SkipList& operator=(const SkipList&) = delete;
+
 	int getRandomLevel();
 
+	Compare key_comp() const {
+		return keyComparator.compareObject();
+	}
+
 	Node<K, V>* createNode(K key, V value, int level);
 
-	void insert(K key, V value);
+	// 插入成功返回 true，键已存在时不做修改并返回 false。右值版本把键值直接移动进节点
+	bool insert(const K& key, const V& value);
+
+	bool insert(K&& key, V&& value);
+
+	// 键不存在时用 args 在节点内原地构造值并返回 true；键已存在时返回 false，args 不会被使用
+	template <typename... Args>
+	bool try_emplace(const K& key, Args&&... args);
+
+	template <typename... Args>
+	bool try_emplace(K&& key, Args&&... args);
+
+	// 由 keyArg 构造键、args 原地构造值，其余同 try_emplace
+	template <typename KeyArg, typename... Args>
+	bool emplace(KeyArg&& keyArg, Args&&... args);
+
+	// 键不存在时插入并返回 true；已存在时把值赋为 value 并返回 false
+	template <typename M>
+	bool insert_or_assign(const K& key, M&& value);
 
-	Node<K, V>* search(K key);
+	template <typename M>
+	bool insert_or_assign(K&& key, M&& value);
 
-	void remove(K key);
+	// 返回值的拷贝，键不存在时返回 std::nullopt
+	std::optional<V> search(const K& key) const;
 
-	void display();
+	// 异构查找：比较器是透明的（如 std::less<>）时，可以直接用能与 K 比较的类型查找，
+	// 例如用 std::string_view 查 std::string 键，不构造临时的 K
+	template <typename Key, typename = detail::EnableIfTransparent<Compare, K, Key>>
+	std::optional<V> search(const Key& key) const;
 
-	// 新增：获取skiplist大小的方法
+	bool contains(const K& key) const;
+
+	template <typename Key, typename = detail::EnableIfTransparent<Compare, K, Key>>
+	bool contains(const Key& key) const;
+
+	// 批量查找，结果按 keys 原来的顺序一一对应。先按键排序，整批只加一次读锁，再从左到右处理：
+	// 键足够密集（平均间隔不超过 kSweepGap 个元素）时，每个键从上一个键的前驱路径继续查找（同 Finger）；
+	// 否则把若干个互不相关的查找交错执行（group prefetching）：每个查找走一步就预取下一个节点，
+	// 转去推进下一个查找，多次缓存缺失因此重叠进行。数据都在缓存中时交错本身的开销可能超过收益
+	std::vector<std::optional<V>> multiGet(Span<const K> keys) const;
+
+	// 使用 finger 的查找与插入，语义与上面的版本相同，并把本次的前驱路径记录回 finger
+	std::optional<V> search(const K& key, Finger& finger) const;
+
+	bool insert(K key, V value, Finger& finger);
+
+	// 删除成功返回 true，键不存在返回 false
+	bool remove(const K& key);
+
+	// 批量写入：对每个 (key, value)，键不存在时插入，已存在时把值改为 value（同 insert_or_assign）。
+	// 先按键排序，整批只加一次写锁；键足够密集时每个键从上一个键的前驱路径继续向后查找（同 multiGet）。
+	// 返回值按 entries 原来的顺序对应，true 表示插入了新键；同一个键出现多次时按原来的先后依次生效，
+	// 最后一次的值保留下来
+	std::vector<bool> multiPut(Span<const std::pair<K, V>> entries);
+
+	// 同上，但键值从 entries 中移动进跳表（插入时移动键和值，覆盖时移动值），调用后这些元素处于被移动后的状态。
+	// Span<std::pair<K, V>> 需要显式构造，例如 sl.multiPut(skiplist::Span<std::pair<K, V>>(entries))
+	std::vector<bool> multiPut(Span<std::pair<K, V>> entries);
+
+	// 批量插入：先按键排序，只加一次写锁，并且每个键从上一个键的前驱路径继续向后查找，
+	// 而不是从 header 重新下降。批内重复的键以先出现的为准，返回成功插入的个数
+	std::size_t insertBatch(std::vector<std::pair<K, V>> batch);
+
+	// 从按键严格递增的 (key, value) 序列线性构建跳表：一次遍历，按确定性层高直接链接到各层尾部。
+	// 不大于前一个键的元素会被跳过。跳表非空时在同一次加锁内按 insertBatch 的方式合并。返回成功插入的个数
+	template <typename InputIt>
+	std::size_t bulkLoad(InputIt first, InputIt last);
+
+	// 把全部元素按顺序保存为快照文件（格式见 serializer.hpp），键值通过 Serializer<K>/<V> 编码。
+	// 边遍历边分块写入文件，不在内存中保存整个编码结果；整个过程持有读锁，写操作在此期间等待，
+	// 得到的是调用时刻的一致快照。
+	// 先写临时文件再改名，失败时返回 false，已有的同名文件保持不变。
+	// sync 为 true 时返回前 fsync 文件及所在目录，掉电后快照也完整（见 writeFileAtomically）
+	bool saveTo(const std::string& path, bool sync = false) const;
+
+	// 加载 saveTo 写出的快照：元素已经有序，直接交给 bulkLoad 线性构建，不逐个插入。
+	// 跳表非空时按 insertBatch 合并，已存在的键保留原值。快照必须由使用相同比较器的跳表写出。
+	// 文件不存在或已损坏时返回 false，跳表保持不变。文件分块读取，但为了在损坏时不改动跳表，
+	// 全部条目先解码到一个临时数组再构建，峰值内存约为最终占用加上这个数组（键值随后移动进节点）
+	bool loadFrom(const std::string& path);
+
+	void display() const;
+
+	// O(1)，不需要加锁
 	int size() const;
+
+	bool empty() const;
+
+	// 第 i 项为出现在第 i 层链表中的节点数（即高度 >= i 的节点数）
+	std::vector<int> levelHistogram() const;
+
+	// 运行期统计的快照（字段见 stats.hpp）。不加锁，不阻塞读写线程。
+	// 没有定义 SKIPLIST_ENABLE_STATS 时只有 levelHistogram 有效，其余计数都为 0
+	SkipListStats stats() const;
+
+	Iterator begin() const;
+
+	Iterator end() const {
+		return Iterator();
+	}
+
+	// 第一个键 >= key 的位置
+	Iterator lower_bound(const K& key) const;
+
+	// 异构版本，条件与 search 相同
+	template <typename Key, typename = detail::EnableIfTransparent<Compare, K, Key>>
+	Iterator lower_bound(const Key& key) const;
+
+	// 第一个键 > key 的位置
+	Iterator upper_bound(const K& key) const;
+
+	// 按比较器的顺序访问 [lo, hi) 内的元素：只从顶层下降一次定位到 lo，之后沿第 0 层顺序前进。
+	// 整个扫描期间持有读锁，回调看到的是一致的快照（写线程会被阻塞到扫描结束），
+	// 因此回调中不能再调用本跳表的写操作。回调返回 false 可提前结束，返回值为访问的元素个数。
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+
+	// 持有读锁按顺序访问全部元素，约束与 scan 相同
+	template <typename Callback>
+	std::size_t forEach(Callback&& callback) const;
 };
 
-template <typename K, typename V>
-SkipList<K, V>::SkipList(int maxLvl, float prob) : maxLevel(maxLvl), p(prob), currentLevel(0) {
-	K dummyKey{};
-	V dummyValue{};
-	header = new Node<K, V>(dummyKey, dummyValue, maxLevel);
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+SkipList<K, V, Compare, Alloc, MaxLevel>::SkipList(int maxLvl, float prob, Alloc alloc,
+												   Compare comp)
+	: maxLevel(std::min(maxLvl, MaxLevel)), p(prob), levelGenerator(p, maxLevel),
+	  keyComparator(std::move(comp)), currentLevel(0), allocator(std::move(alloc)), elementCount(0),
+	  structureVersion(0) {
+	for (int i = 0; i <= MaxLevel; i++) {
+		heightCounts[i].store(0, std::memory_order_relaxed);
+	}
+	// header 的塔固定为 MaxLevel 层，与运行期的 maxLevel 无关，键值只做值初始化
+	header = Node<K, V>::create(allocator, MaxLevel, K{});
+	statistics.recordAllocation(Node<K, V>::allocationSize(MaxLevel));
 }
 
-template <typename K, typename V>
-SkipList<K, V>::~SkipList() {
-	Node<K, V>* current = header->forward[0];
-	while (current != nullptr) {
-		Node<K, V>* temp = current;
-		current = current->forward[0];
-		delete temp;
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+SkipList<K, V, Compare, Alloc, MaxLevel>::~SkipList() {
+	if constexpr (detail::AllocatorBulkRelease<Alloc>::value) {
+		// 内存由分配器整体归还，只有键值需要析构时才遍历链表
+		if constexpr (!std::is_trivially_destructible_v<K> ||
+					  !std::is_trivially_destructible_v<V>) {
+			Node<K, V>* current = header;
+			while (current != nullptr) {
+				Node<K, V>* next = current->forward[0];
+				current->~Node();
+				current = next;
+			}
+		}
+	} else {
+		Node<K, V>* current = header->forward[0];
+		while (current != nullptr) {
+			Node<K, V>* temp = current;
+			current = current->forward[0];
+			Node<K, V>::destroy(allocator, temp);
+		}
+		Node<K, V>::destroy(allocator, header);
 	}
-	delete header;
 }
 
-template <typename K, typename V>
-int SkipList<K, V>::getRandomLevel() {
-	int lvl = 0;
-	while ((double)rand() / RAND_MAX < p && lvl < maxLevel) {
-		lvl++;
-	}
-	return lvl;
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+int SkipList<K, V, Compare, Alloc, MaxLevel>::getRandomLevel() {
+	return levelGenerator();
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::createNode(K key, V value, int level) {
+	return Node<K, V>::create(allocator, level, std::move(key), std::move(value));
 }
 
-template <typename K, typename V>
-Node<K, V>* SkipList<K, V>::createNode(K key, V value, int level) {
-	return new Node<K, V>(key, value, level);
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename KeyArg, typename... Args>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::linkNode(Node<K, V>** update, int level,
+															   KeyArg&& key, Args&&... args) {
+	// 先构造节点，构造抛出异常时跳表保持原样
+	Node<K, V>* newNode = Node<K, V>::create(allocator, level, std::forward<KeyArg>(key),
+											 std::forward<Args>(args)...);
+
+	if (level > currentLevel.load()) {
+		for (int i = currentLevel.load() + 1; i <= level; i++) {
+			update[i] = header;
+		}
+
+		currentLevel.store(level);
+	}
+
+	for (int i = 0; i <= level; i++) {
+		newNode->setForward(i, update[i]->forward[i]);
+		update[i]->setForward(i, newNode);
+	}
+
+	elementCount.fetch_add(1, std::memory_order_relaxed);
+	heightCounts[level].fetch_add(1, std::memory_order_relaxed);
+	statistics.recordAllocation(Node<K, V>::allocationSize(level));
+	return newNode;
 }
 
-template <typename K, typename V>
-void SkipList<K, V>::insert(K key, V value) {
-	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::findPosition(const Key& key,
+																   Node<K, V>** update,
+																   bool& found) const {
+	if constexpr (detail::KeyComparator<K, Compare>::template kUseSuccessorKeys<Key>) {
+		return findPositionBySuccessorKeys(key, update, found);
+	}
 
-	std::vector<Node<K, V>*> update(maxLevel + 1, nullptr);
+	auto probe = keyComparator.probe(key);
 	Node<K, V>* current = header;
+	Node<K, V>* stop = nullptr; // 上一层停下时比较过的节点，它的键不小于 key
+	int stopOrder = 1;          // stop 与 key 的比较结果
+	detail::DescentTrace<MaxLevel> trace;
 
 	for (int i = currentLevel.load(); i >= 0; i--) {
-		while (current->forward[i] != nullptr && current->forward[i]->key < key) {
-			current = current->forward[i];
+		Node<K, V>* next = current->forward[i];
+		while (next != nullptr && next != stop) {
+			// 比较 next 的同时预取下一层的后继：next 不在 key 之前时就要从 current 下降到它，
+			// 两次缓存缺失重叠进行，而不是比较完再等下一层的节点
+			if (i > 0) {
+				detail::prefetch(current->forward[i - 1]);
+			}
+			int order = keyComparator.compare(*next, probe);
+			if (order >= 0) {
+				stop = next;
+				stopOrder = order;
+				break;
+			}
+			current = next;
+			next = current->forward[i];
+			trace.hop(i);
+		}
+		if (update != nullptr) {
+			update[i] = current;
+		}
+	}
+	statistics.recordDescent(trace);
+
+	// 第 0 层停下的位置要么是链表末尾，要么就是 stop
+	Node<K, V>* result = current->forward[0];
+	found = result != nullptr && keyComparator.equivalent(*result, probe, stopOrder);
+	return result;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::findPositionBySuccessorKeys(
+	const K& key, Node<K, V>** update, bool& found) const {
+	using Traits = detail::SuccessorKey<K>;
+	const typename Traits::Code code = Traits::encode(key);
+
+	Node<K, V>* current = header;
+	const typename Traits::Code* codes = header->successorKeys();
+	// header 中高于 currentLevel 的层都没有后继，不必参与比较
+	int levels = currentLevel.load() + 1;
+	detail::DescentTrace<MaxLevel> trace;
+	while (true) {
+		int less = detail::countLess(codes, levels, code);
+		if (update != nullptr) {
+			for (int i = less; i < levels; i++) {
+				update[i] = current;
+			}
 		}
-		update[i] = current;
+		if (less == 0) {
+			break;
+		}
+		// 第 less 层的后继不小于 key，因此前进到的节点高度恰好是 less - 1：
+		// 更高的话它就会是第 less 层的后继。这样下一步的地址只依赖于节点指针本身
+		current = current->forward[less - 1];
+		trace.hop(less - 1);
+		levels = less;
+		codes = current->successorKeys(less - 1);
 	}
 
-	current = current->forward[0];
+	statistics.recordDescent(trace);
+	Node<K, V>* result = current->forward[0];
+	found = result != nullptr && current->successorKeys()[0] == code;
+	return result;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename KeyArg, typename... Args>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::tryEmplaceImpl(KeyArg&& key, Args&&... args) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	auto lock = statistics.lockExclusive(rw_mutex); // 写锁，独占访问
+
+	NodeArray update; // 只会用到第 0..currentLevel 层，linkNode 负责补齐更高的层
+	bool found = false;
+	findPosition(key, update.data(), found);
 
-	if (current != nullptr && current->key == key) {
-		std::cout << "Key " << key << " already exists. Insertion failed." << std::endl;
-		return;
+	if (found) {
+		SKIPLIST_TRACE("Key " << key << " already exists. Insertion failed.");
+		return false;
 	}
 
-	int randomLvl = getRandomLevel();
+	// key 可能已被移动进节点，跟踪输出使用节点里的键
+	[[maybe_unused]] Node<K, V>* newNode = linkNode(
+		update.data(), getRandomLevel(), std::forward<KeyArg>(key), std::forward<Args>(args)...);
 
-	if (randomLvl > currentLevel.load()) {
-		for (int i = currentLevel.load() + 1; i <= randomLvl; i++) {
-			update[i] = header;
+	SKIPLIST_TRACE("Successfully inserted key " << newNode->key);
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename KeyArg, typename M>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insertOrAssignImpl(KeyArg&& key, M&& value) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	auto lock = statistics.lockExclusive(rw_mutex); // 写锁，独占访问
+
+	NodeArray update;
+	bool found = false;
+	Node<K, V>* current = findPosition(key, update.data(), found);
+
+	if (found) {
+		current->value = std::forward<M>(value);
+		return false;
+	}
+
+	linkNode(update.data(), getRandomLevel(), std::forward<KeyArg>(key), std::forward<M>(value));
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insert(const K& key, const V& value) {
+	return tryEmplaceImpl(key, value);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insert(K&& key, V&& value) {
+	return tryEmplaceImpl(std::move(key), std::move(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename... Args>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::try_emplace(const K& key, Args&&... args) {
+	return tryEmplaceImpl(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename... Args>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::try_emplace(K&& key, Args&&... args) {
+	return tryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename KeyArg, typename... Args>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::emplace(KeyArg&& keyArg, Args&&... args) {
+	if constexpr (std::is_same_v<std::decay_t<KeyArg>, K>) {
+		return tryEmplaceImpl(std::forward<KeyArg>(keyArg), std::forward<Args>(args)...);
+	} else {
+		// 比较需要一个完整的 K，先构造出来再移动进节点
+		return tryEmplaceImpl(K(std::forward<KeyArg>(keyArg)), std::forward<Args>(args)...);
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename M>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insert_or_assign(const K& key, M&& value) {
+	return insertOrAssignImpl(key, std::forward<M>(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename M>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insert_or_assign(K&& key, M&& value) {
+	return insertOrAssignImpl(std::move(key), std::forward<M>(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::size_t
+SkipList<K, V, Compare, Alloc, MaxLevel>::insertBatch(std::vector<std::pair<K, V>> batch) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	std::stable_sort(batch.begin(), batch.end(),
+					 [this](const std::pair<K, V>& a, const std::pair<K, V>& b) {
+						 return keyComparator.less(a.first, b.first);
+					 });
+
+	auto lock = statistics.lockExclusive(rw_mutex); // 整批只加一次写锁
+	return insertSortedBatch(batch);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::size_t
+SkipList<K, V, Compare, Alloc, MaxLevel>::insertSortedBatch(std::vector<std::pair<K, V>>& batch) {
+	// 键有序，每个键都从上一个键留在 finger 里的前驱路径继续向后查找
+	Finger finger;
+	std::size_t inserted = 0;
+
+	for (auto& entry : batch) {
+		int level = getRandomLevel();
+		bool found = false;
+		findWithFinger(entry.first, finger, level, found);
+		if (found) {
+			continue; // 已存在，或与批内更早的元素重复
 		}
 
-		currentLevel.store(randomLvl);
+		linkNode(finger.path.data(), level, std::move(entry.first), std::move(entry.second));
+		inserted++;
 	}
 
-	Node<K, V>* newNode = createNode(key, value, randomLvl);
+	return inserted;
+}
 
-	for (int i = 0; i <= randomLvl; i++) {
-		newNode->forward[i] = update[i]->forward[i];
-		update[i]->forward[i] = newNode;
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+int SkipList<K, V, Compare, Alloc, MaxLevel>::deterministicLevel(std::size_t index) const {
+	std::size_t base = static_cast<std::size_t>(1.0f / p + 0.5f);
+	if (base < 2) {
+		base = 2;
 	}
 
-	std::cout << "Successfully inserted key " << key << std::endl;
+	int lvl = 0;
+	while (lvl < maxLevel && index % base == 0) {
+		index /= base;
+		lvl++;
+	}
+	return lvl;
 }
 
-template <typename K, typename V>
-void SkipList<K, V>::remove(K key) {
-	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename InputIt>
+std::size_t SkipList<K, V, Compare, Alloc, MaxLevel>::bulkLoad(InputIt first, InputIt last) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	auto lock = statistics.lockExclusive(rw_mutex); // 写锁，独占访问
 
-	// 寻找各层的前驱节点
-	std::vector<Node<K, V>*> update(maxLevel + 1, nullptr);
-	Node<K, V>* current = header;
+	// 是否为空在同一次加锁内判断并处理，不能放锁后再交给 insertBatch，否则期间可能有其他写入。
+	// 非空时只能在锁内排序；输入通常是 loadFrom 的有序快照，先线性检查一遍，已经有序就不再排序
+	if (elementCount.load(std::memory_order_relaxed) != 0) {
+		std::vector<std::pair<K, V>> batch(first, last);
+		auto less = [this](const std::pair<K, V>& a, const std::pair<K, V>& b) {
+			return keyComparator.less(a.first, b.first);
+		};
+		if (!std::is_sorted(batch.begin(), batch.end(), less)) {
+			std::stable_sort(batch.begin(), batch.end(), less);
+		}
+		return insertSortedBatch(batch);
+	}
 
-	// 从当前最高层开始往下找
-	for (int i = currentLevel.load(); i >= 0; i--) {
-		while (current->forward[i] != nullptr && current->forward[i]->key < key) {
-			current = current->forward[i];
+	// tails[i] 是第 i 层当前的最后一个节点，新节点直接接在各层尾部
+	NodeArray tails;
+	tails.fill(header);
+	std::size_t loaded = 0;
+	int topLevel = currentLevel.load();
+
+	for (; first != last; ++first) {
+		// 传入 move_iterator 时键值直接移动进节点
+		auto&& entry = *first;
+		if (tails[0] != header && !keyComparator.less(tails[0]->key, entry.first)) {
+			continue; // 不满足严格递增
 		}
-		update[i] = current;
+
+		int level = deterministicLevel(loaded + 1);
+		Node<K, V>* newNode =
+			Node<K, V>::create(allocator, level, std::forward<decltype(entry)>(entry).first,
+							   std::forward<decltype(entry)>(entry).second);
+		for (int i = 0; i <= level; i++) {
+			tails[i]->setForward(i, newNode);
+			tails[i] = newNode;
+		}
+
+		topLevel = std::max(topLevel, level);
+		heightCounts[level].fetch_add(1, std::memory_order_relaxed);
+		statistics.recordAllocation(Node<K, V>::allocationSize(level));
+		loaded++;
 	}
 
-	// 移动到第 0 层，定位到可能的目标节点
-	current = current->forward[0];
+	elementCount.fetch_add(static_cast<int>(loaded), std::memory_order_relaxed);
+	currentLevel.store(topLevel);
+	return loaded;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::remove(const K& key) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Remove);
+	auto lock = statistics.lockExclusive(rw_mutex); // 写锁，独占访问
+
+	// 从当前最高层开始往下找，记录各层的前驱节点，定位到第 0 层上可能的目标节点
+	NodeArray update;
+	bool found = false;
+	Node<K, V>* current = findPosition(key, update.data(), found);
 
 	// 检查节点是否存在，如果存在则执行删除
-	if (current != nullptr && current->key == key) {
+	if (found) {
 		// 从最底层开始，逐层解除链接
 		for (int i = 0; i <= currentLevel.load(); i++) {
 			// 如果在第 i 层，前驱节点的下一个节点不是要删的节点，
@@ -142,11 +720,16 @@ void SkipList<K, V>::remove(K key) {
 				break;
 			}
 			// 修改指针，跳过 current 节点
-			update[i]->forward[i] = current->forward[i];
+			update[i]->setForward(i, current->forward[i]);
 		}
 
-		// 释放被删除节点的内存
-		delete current;
+		elementCount.fetch_sub(1, std::memory_order_relaxed);
+		heightCounts[current->level].fetch_sub(1, std::memory_order_relaxed);
+
+		// 释放被删除节点的内存，之前记录的 Finger 可能指向它，一并作废
+		statistics.recordFree(Node<K, V>::allocationSize(current->level));
+		Node<K, V>::destroy(allocator, current);
+		structureVersion++;
 
 		// 清理工作：更新 currentLevel
 		// 检查删除后，最高层是否变空了
@@ -154,41 +737,413 @@ void SkipList<K, V>::remove(K key) {
 			currentLevel.fetch_sub(1);
 		}
 
-		std::cout << "Successfully deleted key " << key << std::endl;
-	} else {
-		std::cout << "Key " << key << " not found. Deletion failed." << std::endl;
+		SKIPLIST_TRACE("Successfully deleted key " << key);
+		return true;
 	}
+
+	SKIPLIST_TRACE("Key " << key << " not found. Deletion failed.");
+	return false;
 }
 
-template <typename K, typename V>
-Node<K, V>* SkipList<K, V>::search(K key) {
-	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁，允许多个线程同时读取
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::findGreaterOrEqual(const Key& key) const {
+	bool found = false;
+	return findPosition(key, nullptr, found);
+}
 
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::findGreaterThan(const K& key) const {
 	Node<K, V>* current = header;
+	Node<K, V>* stop = nullptr; // 已知键大于 key 的节点
+	detail::DescentTrace<MaxLevel> trace;
 
 	for (int i = currentLevel.load(); i >= 0; i--) {
-		while (current->forward[i] != nullptr && current->forward[i]->key < key) {
-			current = current->forward[i];
+		Node<K, V>* next = current->forward[i];
+		while (next != nullptr && next != stop) {
+			if (keyComparator.less(key, next->key)) {
+				stop = next;
+				break;
+			}
+			current = next;
+			next = current->forward[i];
+			trace.hop(i);
 		}
 	}
 
-	// 移动到第 0 层，此时 current 的下一个节点可能是我们要找的
-	current = current->forward[0];
+	statistics.recordDescent(trace);
+	return current->forward[0];
+}
 
-	// 检查第 0 层的下一个节点是不是就是我们要找的
-	if (current != nullptr && current->key == key) {
-		std::cout << "Found key " << key << ", value: " << current->value << std::endl;
-		return current;
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+Node<K, V>* SkipList<K, V, Compare, Alloc, MaxLevel>::findWithFinger(const K& key,
+																	 Finger& finger, int exactLevel,
+																	 bool& found) const {
+	int top = currentLevel.load();
+	if (finger.owner != this || finger.version != structureVersion) {
+		finger.owner = this;
+		finger.version = structureVersion;
+		finger.path.fill(header);
+	} else {
+		// 记录之后跳表长高了，新出现的层从 header 开始
+		for (int i = finger.height + 1; i <= top; i++) {
+			finger.path[i] = header;
+		}
+	}
+	finger.height = top;
+
+	NodeArray& path = finger.path;
+	auto probe = keyComparator.probe(key);
+	auto before = [&probe, this](Node<K, V>* node) {
+		return node == header || keyComparator.compare(*node, probe) < 0;
+	};
+
+	// 路径上的键随层数升高而不增，向上爬到第一个既在 key 之前、下一个节点又不在 key 之前的层
+	int start = 0;
+	while (start < top) {
+		Node<K, V>* next = path[start]->forward[start];
+		if (before(path[start]) && (next == nullptr || keyComparator.compare(*next, probe) >= 0)) {
+			break;
+		}
+		start++;
 	}
+	if (!before(path[start])) {
+		path[start] = header; // key 在整条路径之前，只能从 header 开始
+	}
+	// 插入需要新节点高度以内每一层的精确前驱，更高层上记录的节点一定在 key 之前
+	start = std::max(start, std::min(exactLevel, top));
 
-	std::cout << "Key " << key << " not found." << std::endl;
-	return nullptr;
+	Node<K, V>* current = header;
+	Node<K, V>* stop = nullptr; // 与 findPosition 相同，沿用上一层停下时的比较结果
+	int stopOrder = 1;
+	detail::DescentTrace<MaxLevel> trace;
+	for (int i = start; i >= 0; i--) {
+		// 从上一层下来的位置和本层记录的前驱中选更靠后的一个继续
+		Node<K, V>* recorded = path[i];
+		if (recorded != header && recorded != current && before(recorded) &&
+			(current == header || keyComparator.nodeLess(*current, *recorded))) {
+			current = recorded;
+		}
+		Node<K, V>* next = current->forward[i];
+		while (next != nullptr && next != stop) {
+			int order = keyComparator.compare(*next, probe);
+			if (order >= 0) {
+				stop = next;
+				stopOrder = order;
+				break;
+			}
+			current = next;
+			next = current->forward[i];
+			trace.hop(i);
+		}
+		path[i] = current;
+	}
+	statistics.recordDescent(trace);
+
+	Node<K, V>* result = current->forward[0];
+	found = result != nullptr && keyComparator.equivalent(*result, probe, stopOrder);
+	return result;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key>
+std::optional<V> SkipList<K, V, Compare, Alloc, MaxLevel>::searchImpl(const Key& key) const {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Search);
+	auto lock = statistics.lockShared(rw_mutex); // 读锁，允许多个线程同时读取
+
+	bool found = false;
+	Node<K, V>* current = findPosition(key, nullptr, found);
+
+	if (found) {
+		SKIPLIST_TRACE("Found key " << current->key << ", value: " << current->value);
+		return current->value;
+	}
+
+	SKIPLIST_TRACE("Key " << key << " not found.");
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::containsImpl(const Key& key) const {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Search);
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
+
+	bool found = false;
+	findPosition(key, nullptr, found);
+	return found;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::optional<V> SkipList<K, V, Compare, Alloc, MaxLevel>::search(const K& key) const {
+	return searchImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key, typename>
+std::optional<V> SkipList<K, V, Compare, Alloc, MaxLevel>::search(const Key& key) const {
+	return searchImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::contains(const K& key) const {
+	return containsImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key, typename>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::contains(const Key& key) const {
+	return containsImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::stepLookup(
+	PendingLookup& lookup, std::vector<std::optional<V>>& results) const {
+	if (lookup.finished) {
+		if (lookup.match != nullptr) {
+			results[lookup.index] = lookup.match->value;
+		}
+		statistics.recordDescent(lookup.trace);
+		return true;
+	}
+
+	Node<K, V>* current = lookup.current;
+	if constexpr (detail::KeyComparator<K, Compare>::template kUseSuccessorKeys<K>) {
+		using Traits = detail::SuccessorKey<K>;
+		const typename Traits::Code code = Traits::encode(lookup.probe.key);
+		const typename Traits::Code* codes =
+			current == header ? header->successorKeys() : current->successorKeys(lookup.level - 1);
+		int less = detail::countLess(codes, lookup.level, code);
+		if (less == 0) {
+			lookup.finished = true;
+			if (codes[0] == code) {
+				lookup.match = current->forward[0];
+				detail::prefetch(lookup.match);
+			}
+			return false;
+		}
+		// 与 findPositionBySuccessorKeys 相同，前进到的节点高度恰好是 less - 1
+		current = current->forward[less - 1];
+		lookup.trace.hop(less - 1);
+		lookup.current = current;
+		lookup.level = less;
+		detail::prefetch(current);
+		detail::prefetch(current->successorKeys(less - 1));
+		return false;
+	} else {
+		int i = lookup.level;
+		Node<K, V>* next = current->forward[i];
+		if (next != nullptr && next != lookup.stop) {
+			int order = keyComparator.compare(*next, lookup.probe);
+			if (order < 0) {
+				lookup.current = next;
+				lookup.trace.hop(i);
+				detail::prefetch(next->forward[i]);
+				return false;
+			}
+			lookup.stop = next;
+			lookup.stopOrder = order;
+		}
+		if (i > 0) {
+			lookup.level = i - 1;
+			detail::prefetch(current->forward[i - 1]);
+			return false;
+		}
+
+		Node<K, V>* result = current->forward[0];
+		lookup.finished = true;
+		if (result != nullptr &&
+			keyComparator.equivalent(*result, lookup.probe, lookup.stopOrder)) {
+			lookup.match = result;
+			detail::prefetch(result);
+		}
+		return false;
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename T, typename KeyOf>
+std::vector<std::size_t> SkipList<K, V, Compare, Alloc, MaxLevel>::sortedOrder(Span<const T> items,
+																			   KeyOf keyOf) const {
+	std::vector<std::size_t> order(items.size());
+	for (std::size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+		return keyComparator.less(keyOf(items[a]), keyOf(items[b]));
+	});
+	return order;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::vector<std::optional<V>>
+SkipList<K, V, Compare, Alloc, MaxLevel>::multiGet(Span<const K> keys) const {
+	// 同时进行的查找数，大致与一个核能同时处理的缓存缺失数（行填充缓冲区的个数）相当
+	constexpr std::size_t kGroupSize = 8;
+
+	std::vector<std::optional<V>> results(keys.size());
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Search);
+	// 排序在锁外进行
+	std::vector<std::size_t> order =
+		sortedOrder(keys, [](const K& key) -> const K& { return key; });
+	auto lock = statistics.lockShared(rw_mutex); // 整批只加一次读锁
+
+	std::size_t count = static_cast<std::size_t>(elementCount.load(std::memory_order_relaxed));
+	if (count <= keys.size() * kSweepGap) {
+		Finger finger;
+		for (std::size_t index : order) {
+			bool found = false;
+			Node<K, V>* current = findWithFinger(keys[index], finger, 0, found);
+			if (found) {
+				results[index] = current->value;
+			}
+		}
+		return results;
+	}
+
+	const int top = currentLevel.load();
+	const int startLevel = detail::KeyComparator<K, Compare>::template kUseSuccessorKeys<K>
+							   ? top + 1
+							   : top;
+	std::array<std::optional<PendingLookup>, kGroupSize> group;
+	std::size_t nextKey = 0;
+	std::size_t active = 0;
+	auto start = [&](std::optional<PendingLookup>& slot) {
+		if (nextKey < order.size()) {
+			std::size_t index = order[nextKey];
+			slot.emplace(PendingLookup{index, keyComparator.probe(keys[index]), header, nullptr, 1,
+									   startLevel, nullptr, false, {}});
+			nextKey++;
+			active++;
+		}
+	};
+
+	for (auto& slot : group) {
+		start(slot);
+	}
+	while (active > 0) {
+		for (auto& slot : group) {
+			if (slot && stepLookup(*slot, results)) {
+				slot.reset();
+				active--;
+				start(slot);
+			}
+		}
+	}
+	return results;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::vector<bool>
+SkipList<K, V, Compare, Alloc, MaxLevel>::multiPut(Span<const std::pair<K, V>> entries) {
+	return multiPutImpl(entries);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::vector<bool>
+SkipList<K, V, Compare, Alloc, MaxLevel>::multiPut(Span<std::pair<K, V>> entries) {
+	return multiPutImpl(entries);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Entry>
+std::vector<bool> SkipList<K, V, Compare, Alloc, MaxLevel>::multiPutImpl(Span<Entry> entries) {
+	// const 元素按左值拷贝，否则按右值移动
+	using Source = std::conditional_t<std::is_const_v<Entry>, const std::pair<K, V>&,
+									  std::pair<K, V>&&>;
+
+	std::vector<bool> inserted(entries.size());
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	std::vector<std::size_t> order =
+		sortedOrder(Span<const std::pair<K, V>>(entries),
+					[](const std::pair<K, V>& entry) -> const K& { return entry.first; });
+	auto lock = statistics.lockExclusive(rw_mutex); // 整批只加一次写锁
+
+	// 键密集时与 insertBatch 相同，每个键从上一个键留在 finger 里的前驱路径继续向后查找；
+	// 稀疏时每个键都从 header 下降，整数键因此可以走后继键缓存路径
+	std::size_t count = static_cast<std::size_t>(elementCount.load(std::memory_order_relaxed));
+	const bool sweep = count <= entries.size() * kSweepGap;
+	Finger finger;
+	NodeArray update;
+	Node<K, V>** predecessors = sweep ? finger.path.data() : update.data();
+	for (std::size_t index : order) {
+		Entry& entry = entries[index];
+		int level = getRandomLevel();
+		bool found = false;
+		Node<K, V>* current = sweep ? findWithFinger(entry.first, finger, level, found)
+									: findPosition(entry.first, update.data(), found);
+		if (found) {
+			current->value = std::forward<Source>(entry).second;
+			continue;
+		}
+
+		linkNode(predecessors, level, std::forward<Source>(entry).first,
+				 std::forward<Source>(entry).second);
+		inserted[index] = true;
+	}
+	return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::optional<V> SkipList<K, V, Compare, Alloc, MaxLevel>::search(const K& key,
+																  Finger& finger) const {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Search);
+	auto lock = statistics.lockShared(rw_mutex); // 读锁，finger 属于调用者，不受锁保护
+
+	bool found = false;
+	Node<K, V>* current = findWithFinger(key, finger, 0, found);
+	if (found) {
+		return current->value;
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::insert(K key, V value, Finger& finger) {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Insert);
+	auto lock = statistics.lockExclusive(rw_mutex); // 写锁，独占访问
+
+	// 先确定层高，定位时顺便得到这些层上的精确前驱
+	int level = getRandomLevel();
+	bool found = false;
+	findWithFinger(key, finger, level, found);
+	if (found) {
+		SKIPLIST_TRACE("Key " << key << " already exists. Insertion failed.");
+		return false;
+	}
+
+	[[maybe_unused]] Node<K, V>* newNode =
+		linkNode(finger.path.data(), level, std::move(key), std::move(value));
+
+	SKIPLIST_TRACE("Successfully inserted key " << newNode->key);
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::saveTo(const std::string& path,
+													  bool sync) const {
+	// 边遍历边写文件，整个过程持有读锁，得到调用时刻的一致快照；条目数在写完后回填
+	detail::SnapshotWriter writer(path);
+	std::size_t count = forEach(
+		[&writer](const K& key, const V& value) { writer.append(key, value); });
+	return writer.finish(count, sync);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::loadFrom(const std::string& path) {
+	std::vector<std::pair<K, V>> entries;
+	if (!detail::readSnapshot(path, entries)) {
+		return false;
+	}
+
+	bulkLoad(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+	return true;
 }
 
 // 显示跳表结构
-template <typename K, typename V>
-void SkipList<K, V>::display() {
-	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁，允许多个线程同时读取
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+void SkipList<K, V, Compare, Alloc, MaxLevel>::display() const {
+	auto lock = statistics.lockShared(rw_mutex); // 读锁，允许多个线程同时读取
 
 	std::cout << "\n***** Skip List *****\n";
 	for (int i = currentLevel.load(); i >= 0; i--) {
@@ -202,19 +1157,98 @@ void SkipList<K, V>::display() {
 	}
 }
 
-template <typename K, typename V>
-int SkipList<K, V>::size() const {
-	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+int SkipList<K, V, Compare, Alloc, MaxLevel>::size() const {
+	return elementCount.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+bool SkipList<K, V, Compare, Alloc, MaxLevel>::empty() const {
+	return size() == 0;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+std::vector<int> SkipList<K, V, Compare, Alloc, MaxLevel>::levelHistogram() const {
+	std::vector<int> histogram(maxLevel + 1, 0);
+	int nodesAbove = 0;
+	for (int i = maxLevel; i >= 0; i--) {
+		nodesAbove += heightCounts[i].load(std::memory_order_relaxed);
+		histogram[i] = nodesAbove;
+	}
+	return histogram;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+SkipListStats SkipList<K, V, Compare, Alloc, MaxLevel>::stats() const {
+	SkipListStats result;
+	statistics.fill(result);
+	result.levelHistogram = levelHistogram();
+	return result;
+}
 
-	int count = 0;
-	Node<K, V>* current = header->forward[0];
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+typename SkipList<K, V, Compare, Alloc, MaxLevel>::Iterator
+SkipList<K, V, Compare, Alloc, MaxLevel>::begin() const {
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
+	return Iterator(header->forward[0]);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+typename SkipList<K, V, Compare, Alloc, MaxLevel>::Iterator
+SkipList<K, V, Compare, Alloc, MaxLevel>::lower_bound(const K& key) const {
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
+	return Iterator(findGreaterOrEqual(key));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Key, typename>
+typename SkipList<K, V, Compare, Alloc, MaxLevel>::Iterator
+SkipList<K, V, Compare, Alloc, MaxLevel>::lower_bound(const Key& key) const {
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
+	return Iterator(findGreaterOrEqual(key));
+}
 
-	while (current != nullptr) {
-		count++;
-		current = current->forward[0];
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+typename SkipList<K, V, Compare, Alloc, MaxLevel>::Iterator
+SkipList<K, V, Compare, Alloc, MaxLevel>::upper_bound(const K& key) const {
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
+	return Iterator(findGreaterThan(key));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Callback>
+std::size_t SkipList<K, V, Compare, Alloc, MaxLevel>::scan(const K& lo, const K& hi,
+														   Callback&& callback) const {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Scan);
+	auto lock = statistics.lockShared(rw_mutex); // 读锁，扫描期间保持一致的快照
+
+	std::size_t visited = 0;
+	auto upper = keyComparator.probe(hi);
+	for (Node<K, V>* node = findGreaterOrEqual(lo);
+		 node != nullptr && keyComparator.compare(*node, upper) < 0;
+		 node = node->forward[0]) {
+		visited++;
+		if (!detail::invokeScanCallback(callback, node->key, node->value)) {
+			break;
+		}
 	}
+	return visited;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel>
+template <typename Callback>
+std::size_t SkipList<K, V, Compare, Alloc, MaxLevel>::forEach(Callback&& callback) const {
+	[[maybe_unused]] auto timer = statistics.time(StatsOp::Scan);
+	auto lock = statistics.lockShared(rw_mutex); // 读锁
 
-	return count;
+	std::size_t visited = 0;
+	for (Node<K, V>* node = header->forward[0]; node != nullptr; node = node->forward[0]) {
+		visited++;
+		if (!detail::invokeScanCallback(callback, node->key, node->value)) {
+			break;
+		}
+	}
+	return visited;
 }
 
 } // namespace skiplist
@@ -0,0 +1,91 @@
+#ifndef SPAN_HPP
+#define SPAN_HPP
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace skiplist {
+
+// 连续元素的视图，相当于 C++20 std::span 的一个子集（本库只要求 C++17）。
+// 不拥有元素，调用者需保证视图使用期间底层数组有效。
+// vector、std::array 和花括号列表都可以隐式转换为 Span<const T>，
+// 花括号列表只在所在的完整表达式内有效，因此只适合直接作为函数参数。
+// 可修改的 Span<T> 必须显式构造：接受 Span<T> 的接口可能移动其中的元素（如 SkipList::multiPut），
+// 这样调用者不会在不知情时把自己的数据交出去，同时 Span<T> 与 Span<const T> 两个重载也不会有歧义
+template <typename T>
+class Span {
+private:
+	T* first = nullptr;
+	std::size_t count = 0;
+
+public:
+	using element_type = T;
+	using value_type = std::remove_cv_t<T>;
+	using iterator = T*;
+
+	constexpr Span() = default;
+
+	constexpr Span(T* data, std::size_t size) : first(data), count(size) {}
+
+	template <typename Allocator>
+	explicit Span(std::vector<value_type, Allocator>& vector)
+		: first(vector.data()), count(vector.size()) {}
+
+	template <std::size_t N>
+	explicit constexpr Span(std::array<value_type, N>& array) : first(array.data()), count(N) {}
+
+	// 以下来源只读，只能得到 Span<const T>
+	template <typename Allocator, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+	Span(const std::vector<value_type, Allocator>& vector)
+		: first(vector.data()), count(vector.size()) {}
+
+	template <std::size_t N, typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+	constexpr Span(const std::array<value_type, N>& array) : first(array.data()), count(N) {}
+
+	// 列表的底层数组活到调用所在的完整表达式结束，GCC 对此的警告在这里是预期之内的
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winit-list-lifetime"
+#endif
+	template <typename U = T, typename = std::enable_if_t<std::is_const_v<U>>>
+	constexpr Span(std::initializer_list<value_type> list)
+		: first(list.begin()), count(list.size()) {}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+	// Span<T> 可以转换为 Span<const T>
+	template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T>>>
+	constexpr Span(Span<U> other) : first(other.data()), count(other.size()) {}
+
+	constexpr T* data() const {
+		return first;
+	}
+
+	constexpr std::size_t size() const {
+		return count;
+	}
+
+	constexpr bool empty() const {
+		return count == 0;
+	}
+
+	constexpr T& operator[](std::size_t index) const {
+		return first[index];
+	}
+
+	constexpr iterator begin() const {
+		return first;
+	}
+
+	constexpr iterator end() const {
+		return first + count;
+	}
+};
+
+} // namespace skiplist
+
+#endif // SPAN_HPP
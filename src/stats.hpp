@@ -0,0 +1,428 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+// 运行期统计的编译期开关。在包含本库任何头文件之前定义 SKIPLIST_ENABLE_STATS
+// （或使用 CMake 选项 -DSKIPLIST_ENABLE_STATS=ON）后，SkipList 记录各操作的次数与延迟、
+// 下降路径在各层前进的节点数、rw_mutex 的等待时间和节点分配的字节数，通过 stats() 读取。
+// 未定义时所有记录都编译为空操作，stats() 只填充层高分布。
+// 同一个程序的所有编译单元必须使用相同的设置，否则 SkipList 的布局不一致（违反 ODR）
+namespace skiplist {
+
+namespace detail {
+
+#ifdef SKIPLIST_ENABLE_STATS
+inline constexpr bool kStatsEnabled = true;
+#else
+inline constexpr bool kStatsEnabled = false;
+#endif
+
+// x 不能为 0
+inline int highestBit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(x);
+#else
+	int bit = 0;
+	while (x >>= 1) {
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+} // namespace detail
+
+// 对数分桶的延迟直方图（与 HdrHistogram 的做法相同）：16 ns 以下每纳秒一个桶，
+// 之后每个 2 的幂区间再均分为 8 个桶，以桶的中点作为代表值，相对误差不超过约 6%。
+// 超过 2^40 ns（约 18 分钟）的样本记入最后一个桶。不是线程安全的，多线程时各自记录再 merge
+class LatencyHistogram {
+public:
+	static constexpr int kSubBits = 3;
+	static constexpr int kLinear = 1 << (kSubBits + 1);
+	static constexpr int kMaxExponent = 40;
+	static constexpr int kBuckets = kLinear + (kMaxExponent - kSubBits - 1) * (1 << kSubBits);
+
+	static int bucketOf(std::uint64_t ns) {
+		if (ns < static_cast<std::uint64_t>(kLinear)) {
+			return static_cast<int>(ns);
+		}
+		int exponent = detail::highestBit(ns);
+		if (exponent >= kMaxExponent) {
+			return kBuckets - 1;
+		}
+		int sub = static_cast<int>((ns >> (exponent - kSubBits)) & ((1 << kSubBits) - 1));
+		return kLinear + (exponent - kSubBits - 1) * (1 << kSubBits) + sub;
+	}
+
+	static double valueOf(int bucket) {
+		if (bucket < kLinear) {
+			return bucket;
+		}
+		int exponent = (bucket - kLinear) / (1 << kSubBits) + kSubBits + 1;
+		int sub = (bucket - kLinear) % (1 << kSubBits);
+		return std::ldexp(1.0, exponent) + (sub + 0.5) * std::ldexp(1.0, exponent - kSubBits);
+	}
+
+private:
+	std::array<std::uint64_t, kBuckets> counts{};
+	std::uint64_t total = 0;
+
+public:
+	void record(std::uint64_t ns) {
+		counts[bucketOf(ns)]++;
+		total++;
+	}
+
+	// 直接累加某个桶，用于从分片的原子计数汇总
+	void add(int bucket, std::uint64_t count) {
+		counts[bucket] += count;
+		total += count;
+	}
+
+	void merge(const LatencyHistogram& other) {
+		for (int i = 0; i < kBuckets; i++) {
+			counts[i] += other.counts[i];
+		}
+		total += other.total;
+	}
+
+	std::uint64_t count() const {
+		return total;
+	}
+
+	// q 取 [0, 1]，例如 0.99 为 p99。没有样本时返回 0
+	double percentile(double q) const {
+		if (total == 0) {
+			return 0;
+		}
+		auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+		rank = std::max<std::uint64_t>(rank, 1);
+		std::uint64_t seen = 0;
+		for (int i = 0; i < kBuckets; i++) {
+			seen += counts[i];
+			if (seen >= rank) {
+				return valueOf(i);
+			}
+		}
+		return valueOf(kBuckets - 1);
+	}
+};
+
+// 被统计的操作类别：Search 包括 search/contains，Insert 包括各种插入接口，
+// Scan 包括 scan/forEach。multiGet 每次调用记一次 Search，
+// insertBatch/multiPut/bulkLoad（包括 loadFrom）每次调用记一次 Insert
+enum class StatsOp { Search = 0, Insert = 1, Remove = 2, Scan = 3 };
+
+struct OperationStats {
+	std::uint64_t count = 0;
+	LatencyHistogram latency; // 包括等待锁的时间
+};
+
+struct LockStats {
+	std::uint64_t acquisitions = 0;
+	std::uint64_t contended = 0; // 没能立即拿到、需要等待的次数
+	std::uint64_t waitNanos = 0; // 等待的总时间
+};
+
+// SkipList::stats() 返回的快照。各计数器分别读取，与并发的操作之间不是一个原子的快照
+struct SkipListStats {
+	bool enabled = detail::kStatsEnabled;
+
+	OperationStats search;
+	OperationStats insert;
+	OperationStats remove;
+	OperationStats scan;
+
+	// 从顶层下降定位的次数，以及第 i 层平均每次下降前进的节点数（p = 1/2 时期望约为 1）
+	std::uint64_t descents = 0;
+	std::vector<double> averageHopsPerLevel;
+
+	LockStats sharedLock;
+	LockStats exclusiveLock;
+
+	// 与 levelHistogram() 相同：第 i 项为出现在第 i 层链表中的节点数
+	std::vector<int> levelHistogram;
+
+	// 节点（含 header）累计分配和释放的字节数，差值为当前占用
+	std::uint64_t bytesAllocated = 0;
+	std::uint64_t bytesFreed = 0;
+
+	OperationStats& operation(StatsOp op) {
+		switch (op) {
+		case StatsOp::Search:
+			return search;
+		case StatsOp::Insert:
+			return insert;
+		case StatsOp::Remove:
+			return remove;
+		case StatsOp::Scan:
+			break;
+		}
+		return scan;
+	}
+};
+
+namespace detail {
+
+using StatsClock = std::chrono::steady_clock;
+
+inline std::uint64_t elapsedNanos(StatsClock::time_point start) {
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(StatsClock::now() - start).count());
+}
+
+// 线程按首次使用的顺序轮流分到各个分片，线程数不超过分片数时每个线程独占一个分片
+inline std::size_t statsShardIndex(std::size_t shards) {
+	static std::atomic<std::size_t> nextThread{0};
+	thread_local const std::size_t thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+	return thread % shards;
+}
+
+// 一次下降在各层前进的节点数，先在栈上累计，下降结束后一次性记入统计
+template <int MaxLevel, bool Enabled = kStatsEnabled>
+struct DescentTrace {
+	void hop(int) {}
+};
+
+template <int MaxLevel>
+struct DescentTrace<MaxLevel, true> {
+	std::array<std::uint32_t, MaxLevel + 1> hops{};
+
+	void hop(int level) {
+		hops[level]++;
+	}
+};
+
+// 统计关闭时的收集器：全部为空操作，加锁直接返回锁对象
+template <int MaxLevel, bool Enabled = kStatsEnabled>
+class StatsCollector {
+public:
+	struct Timer {};
+
+	Timer time(StatsOp) const {
+		return Timer{};
+	}
+
+	std::unique_lock<std::shared_mutex> lockExclusive(std::shared_mutex& mutex) const {
+		return std::unique_lock<std::shared_mutex>(mutex);
+	}
+
+	std::shared_lock<std::shared_mutex> lockShared(std::shared_mutex& mutex) const {
+		return std::shared_lock<std::shared_mutex>(mutex);
+	}
+
+	void recordDescent(const DescentTrace<MaxLevel, false>&) const {}
+	void recordAllocation(std::size_t) const {}
+	void recordFree(std::size_t) const {}
+	void fill(SkipListStats&) const {}
+};
+
+// 统计打开时的收集器。计数器按线程分散到 kShards 个缓存行对齐的分片中，
+// 每个线程只写自己的分片（relaxed 原子加），统计本身不会成为新的竞争点；stats() 汇总全部分片。
+// 延迟直方图同样按线程分片，但一组约 9.5 KB，因此只分 kLatencyShards 组（线程数超过时两两共用），
+// 并且每组在该分片第一次记录延迟时才分配：单线程只占一组，最多占 kLatencyShards 组
+template <int MaxLevel>
+class StatsCollector<MaxLevel, true> {
+	static constexpr std::size_t kShards = 16;
+	static constexpr std::size_t kLatencyShards = 8;
+	static constexpr int kOps = 4;
+
+	static_assert(kShards % kLatencyShards == 0, "a counter shard maps to one latency shard");
+
+	struct alignas(64) LatencyBuckets {
+		std::array<std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBuckets>, kOps>
+			counts{};
+	};
+
+	struct LockCounters {
+		std::atomic<std::uint64_t> acquisitions{0};
+		std::atomic<std::uint64_t> contended{0};
+		std::atomic<std::uint64_t> waitNanos{0};
+	};
+
+	struct alignas(64) Shard {
+		std::array<std::atomic<std::uint64_t>, kOps> operations{};
+		std::atomic<std::uint64_t> descents{0};
+		std::array<std::atomic<std::uint64_t>, MaxLevel + 1> hops{};
+		LockCounters shared;
+		LockCounters exclusive;
+		std::atomic<std::uint64_t> bytesAllocated{0};
+		std::atomic<std::uint64_t> bytesFreed{0};
+	};
+
+	std::unique_ptr<Shard[]> shards;
+	mutable std::array<std::atomic<LatencyBuckets*>, kLatencyShards> latency{};
+
+	Shard& local() const {
+		return shards[statsShardIndex(kShards)];
+	}
+
+	// 当前线程的直方图分片，第一次使用时分配；共用该分片的线程同时分配时只保留先装上的一份
+	LatencyBuckets& localLatency() const {
+		std::atomic<LatencyBuckets*>& slot = latency[statsShardIndex(kShards) % kLatencyShards];
+		LatencyBuckets* buckets = slot.load(std::memory_order_acquire);
+		if (buckets == nullptr) {
+			auto created = std::make_unique<LatencyBuckets>();
+			if (slot.compare_exchange_strong(buckets, created.get(), std::memory_order_acq_rel,
+											 std::memory_order_acquire)) {
+				buckets = created.release();
+			}
+		}
+		return *buckets;
+	}
+
+	static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	static std::uint64_t read(const std::atomic<std::uint64_t>& counter) {
+		return counter.load(std::memory_order_relaxed);
+	}
+
+	// 先尝试不等待地加锁，失败时才计时阻塞等待，无竞争时只多一次 try_lock
+	template <typename Lock>
+	static Lock acquire(std::shared_mutex& mutex, LockCounters& counters) {
+		Lock lock(mutex, std::try_to_lock);
+		add(counters.acquisitions, 1);
+		if (!lock.owns_lock()) {
+			auto start = StatsClock::now();
+			lock.lock();
+			add(counters.contended, 1);
+			add(counters.waitNanos, elapsedNanos(start));
+		}
+		return lock;
+	}
+
+	static void fillLock(LockStats& stats, const LockCounters& counters) {
+		stats.acquisitions += read(counters.acquisitions);
+		stats.contended += read(counters.contended);
+		stats.waitNanos += read(counters.waitNanos);
+	}
+
+public:
+	// 析构时记录一次操作及其耗时。直方图分片在构造时取得（第一次使用时在这里分配），
+	// 析构函数只做原子加，不会因为分配失败在 noexcept 的析构中终止程序
+	class Timer {
+		Shard& shard;
+		LatencyBuckets& buckets;
+		StatsOp op;
+		StatsClock::time_point start;
+
+	public:
+		Timer(const StatsCollector* c, StatsOp o)
+			: shard(c->local()), buckets(c->localLatency()), op(o), start(StatsClock::now()) {}
+
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+		~Timer() {
+			auto index = static_cast<std::size_t>(op);
+			add(shard.operations[index], 1);
+			add(buckets.counts[index][LatencyHistogram::bucketOf(elapsedNanos(start))], 1);
+		}
+	};
+
+	StatsCollector() : shards(new Shard[kShards]) {}
+
+	~StatsCollector() {
+		for (auto& slot : latency) {
+			delete slot.load(std::memory_order_relaxed);
+		}
+	}
+
+	StatsCollector(const StatsCollector&) = delete;
+	StatsCollector& operator=(const StatsCollector&) = delete;
+
+	Timer time(StatsOp op) const {
+		return Timer(this, op);
+	}
+
+	std::unique_lock<std::shared_mutex> lockExclusive(std::shared_mutex& mutex) const {
+		return acquire<std::unique_lock<std::shared_mutex>>(mutex, local().exclusive);
+	}
+
+	std::shared_lock<std::shared_mutex> lockShared(std::shared_mutex& mutex) const {
+		return acquire<std::shared_lock<std::shared_mutex>>(mutex, local().shared);
+	}
+
+	void recordDescent(const DescentTrace<MaxLevel, true>& trace) const {
+		Shard& shard = local();
+		add(shard.descents, 1);
+		for (int i = 0; i <= MaxLevel; i++) {
+			if (trace.hops[i] != 0) {
+				add(shard.hops[i], trace.hops[i]);
+			}
+		}
+	}
+
+	void recordAllocation(std::size_t bytes) const {
+		add(local().bytesAllocated, bytes);
+	}
+
+	void recordFree(std::size_t bytes) const {
+		add(local().bytesFreed, bytes);
+	}
+
+	void fill(SkipListStats& stats) const {
+		std::array<std::uint64_t, MaxLevel + 1> hops{};
+		for (const auto& slot : latency) {
+			const LatencyBuckets* buckets = slot.load(std::memory_order_acquire);
+			if (buckets == nullptr) {
+				continue;
+			}
+			for (int op = 0; op < kOps; op++) {
+				OperationStats& operation = stats.operation(static_cast<StatsOp>(op));
+				for (int bucket = 0; bucket < LatencyHistogram::kBuckets; bucket++) {
+					std::uint64_t count = read(buckets->counts[op][bucket]);
+					if (count != 0) {
+						operation.latency.add(bucket, count);
+					}
+				}
+			}
+		}
+		for (std::size_t s = 0; s < kShards; s++) {
+			const Shard& shard = shards[s];
+			for (int op = 0; op < kOps; op++) {
+				stats.operation(static_cast<StatsOp>(op)).count += read(shard.operations[op]);
+			}
+			stats.descents += read(shard.descents);
+			for (int i = 0; i <= MaxLevel; i++) {
+				hops[i] += read(shard.hops[i]);
+			}
+			fillLock(stats.sharedLock, shard.shared);
+			fillLock(stats.exclusiveLock, shard.exclusive);
+			stats.bytesAllocated += read(shard.bytesAllocated);
+			stats.bytesFreed += read(shard.bytesFreed);
+		}
+
+		// 只保留到最高的非零层
+		int top = MaxLevel;
+		while (top > 0 && hops[top] == 0) {
+			top--;
+		}
+		stats.averageHopsPerLevel.assign(top + 1, 0.0);
+		if (stats.descents != 0) {
+			for (int i = 0; i <= top; i++) {
+				stats.averageHopsPerLevel[i] =
+					static_cast<double>(hops[i]) / static_cast<double>(stats.descents);
+			}
+		}
+	}
+};
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // STATS_HPP
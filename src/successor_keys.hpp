@@ -0,0 +1,152 @@
+#ifndef SUCCESSOR_KEYS_HPP
+#define SUCCESSOR_KEYS_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SKIPLIST_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace skiplist {
+
+namespace detail {
+
+// 后继键缓存：32/64 位整数键的节点在 forward 塔之后再保存每一层后继的键（编码为同宽度的有符号数），
+// 遍历时不必访问后继节点本身就能知道是否要前进。不前进的那些比较原本每次都是一次缓存缺失。
+// 编码保持升序：有符号键原样保存，无符号键翻转最高位；没有后继的层保存最大值，它不小于任何查找键
+template <typename K, typename = void>
+struct SuccessorKey {
+	static constexpr bool kEnabled = false;
+};
+
+template <typename K>
+struct SuccessorKey<K, std::enable_if_t<std::is_integral_v<K> && !std::is_same_v<K, bool> &&
+										(sizeof(K) == 4 || sizeof(K) == 8)>> {
+	static constexpr bool kEnabled = true;
+
+	using Code = std::conditional_t<sizeof(K) == 4, std::int32_t, std::int64_t>;
+
+	static constexpr Code kNone = std::numeric_limits<Code>::max();
+
+	static Code encode(K key) {
+		if constexpr (std::is_signed_v<K>) {
+			return static_cast<Code>(key);
+		} else {
+			using Unsigned = std::make_unsigned_t<Code>;
+			constexpr Unsigned kSignBit = Unsigned{1} << (sizeof(Code) * 8 - 1);
+			return static_cast<Code>(static_cast<Unsigned>(key) ^ kSignBit);
+		}
+	}
+};
+
+// 统计 codes[0..count) 中小于 key 的个数。调用方保证 codes 非递减，
+// 因此小于 key 的元素恰好是一个前缀，向量版本遇到不全小于的一组就可以停下
+template <typename Code>
+int countLessScalar(const Code* codes, int count, Code key) {
+	int less = 0;
+	for (int i = 0; i < count; i++) {
+		less += codes[i] < key;
+	}
+	return less;
+}
+
+#ifdef SKIPLIST_X86_DISPATCH
+
+struct CpuFeatures {
+	bool avx2;
+	bool sse42;
+};
+
+inline const CpuFeatures& cpuFeatures() {
+	static const CpuFeatures features = [] {
+		__builtin_cpu_init();
+		return CpuFeatures{__builtin_cpu_supports("avx2") != 0,
+						   __builtin_cpu_supports("sse4.2") != 0};
+	}();
+	return features;
+}
+
+__attribute__((target("avx2"))) inline int countLessAvx2(const std::int64_t* codes, int count,
+														 std::int64_t key) {
+	const __m256i probe = _mm256_set1_epi64x(key);
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + i));
+		int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(probe, block)));
+		if (mask != 0xf) {
+			return i + __builtin_popcount(static_cast<unsigned>(mask));
+		}
+	}
+	return i + countLessScalar(codes + i, count - i, key);
+}
+
+__attribute__((target("avx2"))) inline int countLessAvx2(const std::int32_t* codes, int count,
+														 std::int32_t key) {
+	const __m256i probe = _mm256_set1_epi32(key);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + i));
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(probe, block)));
+		if (mask != 0xff) {
+			return i + __builtin_popcount(static_cast<unsigned>(mask));
+		}
+	}
+	return i + countLessScalar(codes + i, count - i, key);
+}
+
+__attribute__((target("sse4.2"))) inline int countLessSse(const std::int64_t* codes, int count,
+														  std::int64_t key) {
+	const __m128i probe = _mm_set1_epi64x(key);
+	int i = 0;
+	for (; i + 2 <= count; i += 2) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+		int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(probe, block)));
+		if (mask != 0x3) {
+			return i + __builtin_popcount(static_cast<unsigned>(mask));
+		}
+	}
+	return i + countLessScalar(codes + i, count - i, key);
+}
+
+__attribute__((target("sse4.2"))) inline int countLessSse(const std::int32_t* codes, int count,
+														  std::int32_t key) {
+	const __m128i probe = _mm_set1_epi32(key);
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(probe, block)));
+		if (mask != 0xf) {
+			return i + __builtin_popcount(static_cast<unsigned>(mask));
+		}
+	}
+	return i + countLessScalar(codes + i, count - i, key);
+}
+
+#endif // SKIPLIST_X86_DISPATCH
+
+// 按运行时检测到的指令集选择实现。大多数节点只有一两层，不足一个向量时直接逐个比较
+template <typename Code>
+int countLess(const Code* codes, int count, Code key) {
+#ifdef SKIPLIST_X86_DISPATCH
+	constexpr int kSseLanes = static_cast<int>(16 / sizeof(Code));
+	if (count >= kSseLanes) {
+		const CpuFeatures& features = cpuFeatures();
+		if (features.avx2 && count >= 2 * kSseLanes) {
+			return countLessAvx2(codes, count, key);
+		}
+		if (features.sse42) {
+			return countLessSse(codes, count, key);
+		}
+	}
+#endif
+	return countLessScalar(codes, count, key);
+}
+
+} // namespace detail
+
+} // namespace skiplist
+
+#endif // SUCCESSOR_KEYS_HPP
@@ -0,0 +1,983 @@
+#ifndef UNROLLED_SKIPLIST_HPP
+#define UNROLLED_SKIPLIST_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocator.hpp"
+#include "detail.hpp"
+#include "key_compare.hpp"
+#include "level_generator.hpp"
+#include "node.hpp"
+#include "serializer.hpp"
+
+namespace skiplist {
+
+namespace detail {
+
+// 默认的块容量：让键数组大约占两个缓存行（128 字节），至少 4 个、至多 32 个键
+template <typename K>
+constexpr int defaultBlockKeys() {
+	return static_cast<int>(std::clamp<std::size_t>(128 / sizeof(K), 4, 32));
+}
+
+} // namespace detail
+
+// 展开跳表：第 0 层的每个节点是一个块，按序保存最多 BlockKeys 个键值，索引层只链接块。
+// 与 SkipList 相比，查找时沿指针跳转的次数约减少 log2(BlockKeys) 次，剩下的工作是在
+// 连续的键数组里扫描；每个键分摊的指针开销也降到约 1/BlockKeys。
+// 接口与 SkipList 相同（模板参数多一个 BlockKeys），差异在于：
+// - 迭代器解引用得到 (key, value) 的代理对象，而不是节点；
+// - Finger 只缓存上一次命中的块，后续的键仍落在这个块里时不必从顶层下降；
+// - levelHistogram() 统计的是块而不是元素。
+// 块满时对半分裂；删除后与后继块合计不超过 BlockKeys / 2 时合并，块的平均填充率不低于 1/4。
+// K、V 需要可默认构造与移动赋值（见 UnrolledNode）
+template <typename K, typename V, typename Compare = std::less<K>,
+		  typename Alloc = NewDeleteAllocator, int MaxLevel = 32,
+		  int BlockKeys = detail::defaultBlockKeys<K>()>
+class UnrolledSkipList {
+	static_assert(MaxLevel >= 0, "MaxLevel must be non-negative");
+	static_assert(BlockKeys >= 2, "BlockKeys must be at least 2");
+
+private:
+	using Block = UnrolledNode<K, V, BlockKeys>;
+	using BlockArray = std::array<Block*, MaxLevel + 1>;
+
+	// 比较廉价的键在块内逐个比较并累加结果：没有分支，编译器可以向量化；
+	// 其他键（如字符串）用二分查找减少比较次数
+	static constexpr bool kLinearScan = std::is_arithmetic_v<K> || std::is_pointer_v<K>;
+
+	int maxLevel;
+	float p;
+	detail::LevelGenerator levelGenerator;
+	detail::KeyComparator<K, Compare> keyComparator;
+	int currentLevel;
+	Alloc allocator;
+	Block* header; // 不保存元素，只提供各层的链表头
+	mutable std::shared_mutex rw_mutex;
+	std::atomic<int> elementCount;
+	std::atomic<int> heightCounts[MaxLevel + 1]; // 各高度的块数
+	// 每次链接或释放块时加一，Finger 缓存的块只在版本号未变时可以直接使用。写锁内修改
+	std::uint64_t structureVersion;
+
+	// 返回最后一个首键不大于 key 的块（inclusive 为 false 时为首键小于 key 的块），
+	// 不存在时返回 header。update 不为空时记录各层的这样的块。调用者需持有锁
+	template <typename Key>
+	Block* findBlock(const Key& key, Block** update, bool inclusive) const;
+
+	// 块内第一个不小于 key 的位置
+	template <typename Key>
+	int lowerBoundInBlock(const Block* block, const Key& key) const;
+
+	// 块内第一个大于 key 的位置
+	int upperBoundInBlock(const Block* block, const K& key) const;
+
+	// 定位 key：返回 findBlock 找到的块，position 为块内的 lower bound，found 表示键是否存在
+	template <typename Key>
+	Block* locate(const Key& key, Block** update, int& position, bool& found) const;
+
+	// key 不小于 block 的首键、且小于后继块的首键时，它只可能位于这个块里
+	bool blockCovers(const Block* block, const K& key) const;
+
+	// 在 update 给出的各层前驱之后链接一个高度为 level 的空块，调用者需持有写锁
+	Block* linkBlock(Block** update, int level);
+
+	// 把块从各层摘除并释放，preds 为各层首键小于该块首键的最后一个块。调用者需持有写锁
+	void unlinkBlock(Block* block, Block** preds);
+
+	// 把键值放到 block 的 position 处，块满时先对半分裂。block 为 header 时表示 key
+	// 小于所有元素，放进第一个块。update 为 locate 记录的各层块。返回键最终所在的块，调用者需持有写锁
+	Block* insertAt(Block* block, int position, Block** update, K key, V value);
+
+	// 写锁内的插入：键不存在时由 args 构造值并插入。返回键所在的块（已存在时为它原来的块）和是否插入
+	template <typename KeyArg, typename... Args>
+	std::pair<Block*, bool> emplaceLocked(KeyArg&& key, Args&&... args);
+
+	// insertBatch 的主体：batch 已按键稳定排序，调用者需持有写锁
+	std::size_t insertSortedBatch(std::vector<std::pair<K, V>>& batch);
+
+	template <typename KeyArg, typename... Args>
+	bool tryEmplaceImpl(KeyArg&& key, Args&&... args);
+
+	template <typename KeyArg, typename M>
+	bool insertOrAssignImpl(KeyArg&& key, M&& value);
+
+	template <typename Key>
+	std::optional<V> searchImpl(const Key& key) const;
+
+	template <typename Key>
+	bool containsImpl(const Key& key) const;
+
+	// 与 SkipList::deterministicLevel 相同，bulkLoad 按块的序号使用
+	int deterministicLevel(std::size_t index) const;
+
+public:
+	// 查找提示：记录上一次查找命中的块。键有局部性时，下一次查找如果仍落在这个块里，
+	// 只需检查块的首键和后继块的首键，不必从顶层下降。
+	// Finger 由调用者持有，不是线程安全的；任何块的分裂、合并或释放都会使它失效，
+	// 下一次使用时自动退回普通查找
+	class Finger {
+	private:
+		friend class UnrolledSkipList;
+
+		const UnrolledSkipList* owner = nullptr;
+		std::uint64_t version = 0;
+		Block* block = nullptr;
+
+	public:
+		Finger() = default;
+
+		void reset() {
+			owner = nullptr;
+		}
+	};
+
+	// 按键的顺序遍历所有元素的只读迭代器。元素存放在块内的数组里，解引用得到的是
+	// 引用键和值的代理对象（通过 it->key / it->value 访问），因此只是输入迭代器。
+	// 与 SkipList 的迭代器一样，只在定位起点时加读锁，遍历期间不能有并发的写操作
+	class Iterator {
+	private:
+		const Block* block;
+		int index;
+
+	public:
+		struct Entry {
+			const K& key;
+			const V& value;
+
+			const Entry* operator->() const {
+				return this;
+			}
+		};
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = Entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Entry;
+		using reference = Entry;
+
+		explicit Iterator(const Block* b = nullptr, int i = 0) : block(b), index(i) {}
+
+		reference operator*() const {
+			return Entry{block->keys[index], block->values[index]};
+		}
+
+		pointer operator->() const {
+			return **this;
+		}
+
+		Iterator& operator++() {
+			if (++index == block->count) {
+				block = block->forward[0];
+				index = 0;
+			}
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const {
+			return block == other.block && index == other.index;
+		}
+
+		bool operator!=(const Iterator& other) const {
+			return !(*this == other);
+		}
+	};
+
+	using iterator = Iterator;
+	using const_iterator = Iterator;
+
+	explicit UnrolledSkipList(int maxLvl = MaxLevel, float prob = 0.5, Alloc alloc = Alloc(),
+							  Compare comp = Compare());
+	~UnrolledSkipList();
+
+	UnrolledSkipList(const UnrolledSkipList&) = delete;
+	UnrolledSkipList& operator=(const UnrolledSkipList&) = delete;
+
+	int getRandomLevel();
+
+	Compare key_comp() const {
+		return keyComparator.compareObject();
+	}
+
+	// 以下接口的语义与 SkipList 中的同名函数相同
+	bool insert(const K& key, const V& value);
+
+	bool insert(K&& key, V&& value);
+
+	template <typename... Args>
+	bool try_emplace(const K& key, Args&&... args);
+
+	template <typename... Args>
+	bool try_emplace(K&& key, Args&&... args);
+
+	template <typename KeyArg, typename... Args>
+	bool emplace(KeyArg&& keyArg, Args&&... args);
+
+	template <typename M>
+	bool insert_or_assign(const K& key, M&& value);
+
+	template <typename M>
+	bool insert_or_assign(K&& key, M&& value);
+
+	std::optional<V> search(const K& key) const;
+
+	template <typename Key, typename = detail::EnableIfTransparent<Compare, K, Key>>
+	std::optional<V> search(const Key& key) const;
+
+	bool contains(const K& key) const;
+
+	template <typename Key, typename = detail::EnableIfTransparent<Compare, K, Key>>
+	bool contains(const Key& key) const;
+
+	std::optional<V> search(const K& key, Finger& finger) const;
+
+	bool insert(K key, V value, Finger& finger);
+
+	bool remove(const K& key);
+
+	std::size_t insertBatch(std::vector<std::pair<K, V>> batch);
+
+	// 跳表为空时把严格递增的输入依次装满各个块，按块的序号分配确定性层高
+	template <typename InputIt>
+	std::size_t bulkLoad(InputIt first, InputIt last);
+
+	// 快照格式与 SkipList 相同，两者写出的文件可以互相加载。sync 的含义同 SkipList::saveTo
+	bool saveTo(const std::string& path, bool sync = false) const;
+
+	bool loadFrom(const std::string& path);
+
+	void display() const;
+
+	int size() const;
+
+	bool empty() const;
+
+	// 第 i 项为出现在第 i 层链表中的块数，第 0 项即块的总数
+	std::vector<int> levelHistogram() const;
+
+	Iterator begin() const;
+
+	Iterator end() const {
+		return Iterator();
+	}
+
+	Iterator lower_bound(const K& key) const;
+
+	Iterator upper_bound(const K& key) const;
+
+	template <typename Callback>
+	std::size_t scan(const K& lo, const K& hi, Callback&& callback) const;
+
+	template <typename Callback>
+	std::size_t forEach(Callback&& callback) const;
+};
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::UnrolledSkipList(int maxLvl,
+																			  float prob,
+																			  Alloc alloc,
+																			  Compare comp)
+	: maxLevel(std::min(maxLvl, MaxLevel)), p(prob), levelGenerator(p, maxLevel),
+	  keyComparator(std::move(comp)), currentLevel(0), allocator(std::move(alloc)), elementCount(0),
+	  structureVersion(0) {
+	for (int i = 0; i <= MaxLevel; i++) {
+		heightCounts[i].store(0, std::memory_order_relaxed);
+	}
+	header = Block::create(allocator, MaxLevel);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::~UnrolledSkipList() {
+	if constexpr (detail::AllocatorBulkRelease<Alloc>::value) {
+		if constexpr (!std::is_trivially_destructible_v<K> ||
+					  !std::is_trivially_destructible_v<V>) {
+			Block* current = header;
+			while (current != nullptr) {
+				Block* next = current->forward[0];
+				current->~Block();
+				current = next;
+			}
+		}
+	} else {
+		Block* current = header;
+		while (current != nullptr) {
+			Block* next = current->forward[0];
+			Block::destroy(allocator, current);
+			current = next;
+		}
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+int UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::getRandomLevel() {
+	return levelGenerator();
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Block*
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::findBlock(const Key& key,
+																	   Block** update,
+																	   bool inclusive) const {
+	Block* current = header;
+	Block* stop = nullptr; // 上一层停下时的块，已知不满足条件
+
+	for (int i = currentLevel; i >= 0; i--) {
+		Block* next = current->forward[i];
+		while (next != nullptr && next != stop &&
+			   (inclusive ? !keyComparator.less(key, next->keys[0])
+						  : keyComparator.less(next->keys[0], key))) {
+			current = next;
+			next = current->forward[i];
+		}
+		stop = next;
+		if (update != nullptr) {
+			update[i] = current;
+		}
+	}
+	return current;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key>
+int UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::lowerBoundInBlock(
+	const Block* block, const Key& key) const {
+	if constexpr (kLinearScan) {
+		int position = 0;
+		for (int i = 0; i < block->count; i++) {
+			position += keyComparator.less(block->keys[i], key);
+		}
+		return position;
+	} else {
+		const K* keys = block->keys;
+		return static_cast<int>(std::lower_bound(keys, keys + block->count, key,
+												 [this](const K& a, const Key& b) {
+													 return keyComparator.less(a, b);
+												 }) -
+								keys);
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+int UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::upperBoundInBlock(
+	const Block* block, const K& key) const {
+	if constexpr (kLinearScan) {
+		int position = 0;
+		for (int i = 0; i < block->count; i++) {
+			position += !keyComparator.less(key, block->keys[i]);
+		}
+		return position;
+	} else {
+		const K* keys = block->keys;
+		return static_cast<int>(std::upper_bound(keys, keys + block->count, key,
+												 [this](const K& a, const K& b) {
+													 return keyComparator.less(a, b);
+												 }) -
+								keys);
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Block*
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::locate(const Key& key,
+																	Block** update,
+																	int& position,
+																	bool& found) const {
+	Block* block = findBlock(key, update, true);
+	position = lowerBoundInBlock(block, key);
+	found = position < block->count && !keyComparator.less(key, block->keys[position]);
+	return block;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::blockCovers(const Block* block,
+																			  const K& key) const {
+	const Block* next = block->forward[0];
+	return !keyComparator.less(key, block->keys[0]) &&
+		   (next == nullptr || keyComparator.less(key, next->keys[0]));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Block*
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::linkBlock(Block** update,
+																	   int level) {
+	Block* block = Block::create(allocator, level);
+
+	if (level > currentLevel) {
+		for (int i = currentLevel + 1; i <= level; i++) {
+			update[i] = header;
+		}
+		currentLevel = level;
+	}
+
+	for (int i = 0; i <= level; i++) {
+		block->forward[i] = update[i]->forward[i];
+		update[i]->forward[i] = block;
+	}
+
+	heightCounts[level].fetch_add(1, std::memory_order_relaxed);
+	structureVersion++;
+	return block;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+void UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::unlinkBlock(Block* block,
+																			  Block** preds) {
+	for (int i = 0; i <= block->level; i++) {
+		preds[i]->forward[i] = block->forward[i];
+	}
+
+	heightCounts[block->level].fetch_sub(1, std::memory_order_relaxed);
+	Block::destroy(allocator, block);
+	structureVersion++;
+
+	while (currentLevel > 0 && header->forward[currentLevel] == nullptr) {
+		currentLevel--;
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Block*
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insertAt(Block* block, int position,
+																	  Block** update, K key,
+																	  V value) {
+	if (block == header) {
+		// key 小于所有元素：放到第一个块的开头，它在各层的位置不变
+		block = header->forward[0];
+		position = 0;
+		if (block == nullptr) {
+			block = linkBlock(update, getRandomLevel());
+		} else {
+			for (int i = 0; i <= block->level; i++) {
+				update[i] = block;
+			}
+		}
+	}
+
+	if (block->count == BlockKeys) {
+		// 后一半移到紧随其后的新块。update 中高于 block 的层是首键不大于 key 的最后一个块，
+		// 它们在这些层上的后继都在 block 之后，因此同样是新块的前驱
+		Block* right = linkBlock(update, getRandomLevel());
+		int half = BlockKeys / 2;
+		std::move(block->keys + half, block->keys + BlockKeys, right->keys);
+		std::move(block->values + half, block->values + BlockKeys, right->values);
+		right->count = BlockKeys - half;
+		block->count = half;
+		if (position > half) {
+			block = right;
+			position -= half;
+		}
+	}
+
+	std::move_backward(block->keys + position, block->keys + block->count,
+					   block->keys + block->count + 1);
+	std::move_backward(block->values + position, block->values + block->count,
+					   block->values + block->count + 1);
+	block->keys[position] = std::move(key);
+	block->values[position] = std::move(value);
+	block->count++;
+	elementCount.fetch_add(1, std::memory_order_relaxed);
+	return block;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename KeyArg, typename... Args>
+std::pair<typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Block*, bool>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::emplaceLocked(KeyArg&& key,
+																		   Args&&... args) {
+	BlockArray update;
+	int position = 0;
+	bool found = false;
+	Block* block = locate(key, update.data(), position, found);
+	if (found) {
+		return {block, false};
+	}
+
+	// 先构造键值，构造抛出异常时跳表保持原样
+	block = insertAt(block, position, update.data(), K(std::forward<KeyArg>(key)),
+					 V(std::forward<Args>(args)...));
+	return {block, true};
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename KeyArg, typename... Args>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::tryEmplaceImpl(KeyArg&& key,
+																				 Args&&... args) {
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+	return emplaceLocked(std::forward<KeyArg>(key), std::forward<Args>(args)...).second;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename KeyArg, typename M>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insertOrAssignImpl(KeyArg&& key,
+																					 M&& value) {
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+
+	BlockArray update;
+	int position = 0;
+	bool found = false;
+	Block* block = locate(key, update.data(), position, found);
+	if (found) {
+		block->values[position] = std::forward<M>(value);
+		return false;
+	}
+
+	insertAt(block, position, update.data(), K(std::forward<KeyArg>(key)),
+			 V(std::forward<M>(value)));
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insert(const K& key,
+																		 const V& value) {
+	return tryEmplaceImpl(key, value);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insert(K&& key, V&& value) {
+	return tryEmplaceImpl(std::move(key), std::move(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename... Args>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::try_emplace(const K& key,
+																			  Args&&... args) {
+	return tryEmplaceImpl(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename... Args>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::try_emplace(K&& key,
+																			  Args&&... args) {
+	return tryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename KeyArg, typename... Args>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::emplace(KeyArg&& keyArg,
+																		  Args&&... args) {
+	if constexpr (std::is_same_v<std::decay_t<KeyArg>, K>) {
+		return tryEmplaceImpl(std::forward<KeyArg>(keyArg), std::forward<Args>(args)...);
+	} else {
+		return tryEmplaceImpl(K(std::forward<KeyArg>(keyArg)), std::forward<Args>(args)...);
+	}
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename M>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insert_or_assign(const K& key,
+																				   M&& value) {
+	return insertOrAssignImpl(key, std::forward<M>(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename M>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insert_or_assign(K&& key,
+																				   M&& value) {
+	return insertOrAssignImpl(std::move(key), std::forward<M>(value));
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key>
+std::optional<V>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::searchImpl(const Key& key) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	int position = 0;
+	bool found = false;
+	Block* block = locate(key, nullptr, position, found);
+	if (found) {
+		return block->values[position];
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::containsImpl(
+	const Key& key) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	int position = 0;
+	bool found = false;
+	locate(key, nullptr, position, found);
+	return found;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+std::optional<V>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::search(const K& key) const {
+	return searchImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key, typename>
+std::optional<V>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::search(const Key& key) const {
+	return searchImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::contains(const K& key) const {
+	return containsImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Key, typename>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::contains(const Key& key) const {
+	return containsImpl(key);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+std::optional<V> UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::search(
+	const K& key, Finger& finger) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁，finger 属于调用者，不受锁保护
+
+	Block* block = nullptr;
+	if (finger.owner == this && finger.version == structureVersion &&
+		blockCovers(finger.block, key)) {
+		block = finger.block;
+	} else {
+		block = findBlock(key, nullptr, true);
+	}
+
+	if (block != header) {
+		finger.owner = this;
+		finger.version = structureVersion;
+		finger.block = block;
+	}
+
+	int position = lowerBoundInBlock(block, key);
+	if (position < block->count && !keyComparator.less(key, block->keys[position])) {
+		return block->values[position];
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insert(K key, V value,
+																		 Finger& finger) {
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+
+	// 缓存的块仍然覆盖 key 且还有空位时直接放进去，块的结构不变；否则走普通插入
+	if (finger.owner == this && finger.version == structureVersion &&
+		finger.block->count < BlockKeys && blockCovers(finger.block, key)) {
+		Block* block = finger.block;
+		int position = lowerBoundInBlock(block, key);
+		if (position < block->count && !keyComparator.less(key, block->keys[position])) {
+			return false;
+		}
+		BlockArray unused; // 块不会分裂，用不到各层的前驱
+		insertAt(block, position, unused.data(), std::move(key), std::move(value));
+		return true;
+	}
+
+	// 记住插入 key 之后 key 所在的块
+	auto [block, inserted] = emplaceLocked(std::move(key), std::move(value));
+	finger.owner = this;
+	finger.version = structureVersion;
+	finger.block = block;
+	return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::remove(const K& key) {
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+
+	int position = 0;
+	bool found = false;
+	Block* block = locate(key, nullptr, position, found);
+	if (!found) {
+		return false;
+	}
+
+	elementCount.fetch_sub(1, std::memory_order_relaxed);
+
+	if (block->count == 1) {
+		// 块中唯一的元素，它的首键就是 key，整个块摘除
+		BlockArray preds;
+		findBlock(key, preds.data(), false);
+		unlinkBlock(block, preds.data());
+		return true;
+	}
+
+	std::move(block->keys + position + 1, block->keys + block->count, block->keys + position);
+	std::move(block->values + position + 1, block->values + block->count,
+			  block->values + position);
+	block->count--;
+	// 空出的槽位重置为默认值，及时释放键值持有的资源
+	block->keys[block->count] = K();
+	block->values[block->count] = V();
+
+	// 与后继块合计不超过半个块时，把后继块的元素并进来并释放后继块
+	Block* next = block->forward[0];
+	if (next != nullptr && block->count + next->count <= BlockKeys / 2) {
+		BlockArray preds;
+		findBlock(next->keys[0], preds.data(), false);
+		std::move(next->keys, next->keys + next->count, block->keys + block->count);
+		std::move(next->values, next->values + next->count, block->values + block->count);
+		block->count += next->count;
+		unlinkBlock(next, preds.data());
+	}
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+std::size_t UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insertBatch(
+	std::vector<std::pair<K, V>> batch) {
+	std::stable_sort(batch.begin(), batch.end(),
+					 [this](const std::pair<K, V>& a, const std::pair<K, V>& b) {
+						 return keyComparator.less(a.first, b.first);
+					 });
+
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 整批只加一次写锁
+	return insertSortedBatch(batch);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+std::size_t UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::insertSortedBatch(
+	std::vector<std::pair<K, V>>& batch) {
+	std::size_t inserted = 0;
+	for (auto& entry : batch) {
+		if (emplaceLocked(std::move(entry.first), std::move(entry.second)).second) {
+			inserted++;
+		}
+	}
+	return inserted;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+int UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::deterministicLevel(
+	std::size_t index) const {
+	std::size_t base = static_cast<std::size_t>(1.0f / p + 0.5f);
+	if (base < 2) {
+		base = 2;
+	}
+
+	int lvl = 0;
+	while (lvl < maxLevel && index % base == 0) {
+		index /= base;
+		lvl++;
+	}
+	return lvl;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename InputIt>
+std::size_t UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::bulkLoad(InputIt first,
+																				  InputIt last) {
+	std::unique_lock<std::shared_mutex> lock(rw_mutex); // 写锁，独占访问
+
+	// 与 SkipList::bulkLoad 相同，非空时在同一次加锁内排序并逐个插入
+	if (elementCount.load(std::memory_order_relaxed) != 0) {
+		std::vector<std::pair<K, V>> batch(first, last);
+		auto less = [this](const std::pair<K, V>& a, const std::pair<K, V>& b) {
+			return keyComparator.less(a.first, b.first);
+		};
+		if (!std::is_sorted(batch.begin(), batch.end(), less)) {
+			std::stable_sort(batch.begin(), batch.end(), less);
+		}
+		return insertSortedBatch(batch);
+	}
+
+	// tails[i] 是第 i 层当前的最后一个块
+	BlockArray tails;
+	tails.fill(header);
+	std::size_t loaded = 0;
+	std::size_t blocks = 0;
+
+	for (; first != last; ++first) {
+		auto&& entry = *first;
+		Block* tail = tails[0];
+		if (tail != header && !keyComparator.less(tail->keys[tail->count - 1], entry.first)) {
+			continue; // 不满足严格递增
+		}
+
+		if (tail == header || tail->count == BlockKeys) {
+			int level = deterministicLevel(++blocks);
+			tail = Block::create(allocator, level);
+			for (int i = 0; i <= level; i++) {
+				tails[i]->forward[i] = tail;
+				tails[i] = tail;
+			}
+			currentLevel = std::max(currentLevel, level);
+			heightCounts[level].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		tail->keys[tail->count] = std::forward<decltype(entry)>(entry).first;
+		tail->values[tail->count] = std::forward<decltype(entry)>(entry).second;
+		tail->count++;
+		loaded++;
+	}
+
+	elementCount.fetch_add(static_cast<int>(loaded), std::memory_order_relaxed);
+	structureVersion++;
+	return loaded;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::saveTo(
+	const std::string& path, bool sync) const {
+	// 与 SkipList::saveTo 相同，持有读锁边遍历边写文件
+	detail::SnapshotWriter writer(path);
+	std::size_t count = forEach(
+		[&writer](const K& key, const V& value) { writer.append(key, value); });
+	return writer.finish(count, sync);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::loadFrom(
+	const std::string& path) {
+	std::vector<std::pair<K, V>> entries;
+	if (!detail::readSnapshot(path, entries)) {
+		return false;
+	}
+
+	bulkLoad(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+	return true;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+void UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::display() const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	std::cout << "\n***** Unrolled Skip List *****\n";
+	for (int i = currentLevel; i >= 1; i--) {
+		std::cout << "Level " << i << ": ";
+		for (Block* block = header->forward[i]; block != nullptr; block = block->forward[i]) {
+			std::cout << block->keys[0] << " ";
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "Level 0: ";
+	for (Block* block = header->forward[0]; block != nullptr; block = block->forward[0]) {
+		std::cout << "[";
+		for (int j = 0; j < block->count; j++) {
+			std::cout << (j == 0 ? "" : " ") << block->keys[j] << ":" << block->values[j];
+		}
+		std::cout << "] ";
+	}
+	std::cout << std::endl;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+int UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::size() const {
+	return elementCount.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+bool UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::empty() const {
+	return size() == 0;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+std::vector<int>
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::levelHistogram() const {
+	std::vector<int> histogram(maxLevel + 1, 0);
+	int blocksAbove = 0;
+	for (int i = maxLevel; i >= 0; i--) {
+		blocksAbove += heightCounts[i].load(std::memory_order_relaxed);
+		histogram[i] = blocksAbove;
+	}
+	return histogram;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Iterator
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::begin() const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+	return Iterator(header->forward[0], 0);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Iterator
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::lower_bound(const K& key) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	Block* block = findBlock(key, nullptr, true);
+	int position = lowerBoundInBlock(block, key);
+	// header 中没有元素，块内越过末尾时都落到下一个块的开头
+	if (position == block->count) {
+		return Iterator(block->forward[0], 0);
+	}
+	return Iterator(block, position);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+typename UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::Iterator
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::upper_bound(const K& key) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	Block* block = findBlock(key, nullptr, true);
+	int position = upperBoundInBlock(block, key);
+	if (position == block->count) {
+		return Iterator(block->forward[0], 0);
+	}
+	return Iterator(block, position);
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Callback>
+std::size_t UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::scan(
+	const K& lo, const K& hi, Callback&& callback) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁，扫描期间保持一致的快照
+
+	std::size_t visited = 0;
+	Block* block = findBlock(lo, nullptr, true);
+	int position = lowerBoundInBlock(block, lo);
+	for (; block != nullptr; block = block->forward[0], position = 0) {
+		for (; position < block->count; position++) {
+			if (!keyComparator.less(block->keys[position], hi)) {
+				return visited;
+			}
+			visited++;
+			if (!detail::invokeScanCallback(callback, block->keys[position],
+											block->values[position])) {
+				return visited;
+			}
+		}
+	}
+	return visited;
+}
+
+template <typename K, typename V, typename Compare, typename Alloc, int MaxLevel, int BlockKeys>
+template <typename Callback>
+std::size_t
+UnrolledSkipList<K, V, Compare, Alloc, MaxLevel, BlockKeys>::forEach(Callback&& callback) const {
+	std::shared_lock<std::shared_mutex> lock(rw_mutex); // 读锁
+
+	std::size_t visited = 0;
+	for (Block* block = header->forward[0]; block != nullptr; block = block->forward[0]) {
+		for (int i = 0; i < block->count; i++) {
+			visited++;
+			if (!detail::invokeScanCallback(callback, block->keys[i], block->values[i])) {
+				return visited;
+			}
+		}
+	}
+	return visited;
+}
+
+} // namespace skiplist
+
+#endif // UNROLLED_SKIPLIST_HPP
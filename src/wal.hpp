@@ -0,0 +1,318 @@
+#ifndef WAL_HPP
+#define WAL_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "serializer.hpp"
+
+namespace skiplist {
+
+namespace detail {
+
+// CRC-32（IEEE 802.3 多项式），用于发现日志末尾写了一半的记录
+inline std::uint32_t crc32(const char* data, std::size_t size) {
+	static const std::array<std::uint32_t, 256> table = [] {
+		std::array<std::uint32_t, 256> entries{};
+		for (std::uint32_t i = 0; i < 256; i++) {
+			std::uint32_t crc = i;
+			for (int bit = 0; bit < 8; bit++) {
+				crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+			}
+			entries[i] = crc;
+		}
+		return entries;
+	}();
+
+	std::uint32_t crc = 0xffffffffu;
+	for (std::size_t i = 0; i < size; i++) {
+		crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffffu;
+}
+
+} // namespace detail
+
+// 日志记录的类型。insert_or_assign 和 remove 在重放时都是幂等的，
+// 因此快照之后、截断之前崩溃导致的重复重放不会改变结果
+enum class WalOp : std::uint8_t {
+	Put = 1,
+	Remove = 2,
+};
+
+// 预写日志（write-ahead log），支持组提交。文件由一条条记录组成：
+//
+//   payload 长度（uint32）| payload 的 CRC-32（uint32）| payload
+//   payload = 操作（uint8）| Serializer<K> 编码的键 | Put 时再跟 Serializer<V> 编码的值
+//
+// append() 只把记录编码到内存缓冲区并返回序号；commit(seq) 等待该序号之前的记录全部落盘。
+// 同时等待的多个线程中只有一个（leader）在锁外执行 write + fsync，一次写出此前所有线程追加的记录，
+// 其他线程等它完成，因此并发写入时多次提交共用一次 fsync。
+// 一次写入或 fsync 失败后日志进入失败状态，那一批以及之后追加的记录的 commit 都返回 false。
+// 文件句柄只在持有 mutex 且没有 leader 在写时才会被 open/close/reset 替换，leader 在锁内取出它再写
+template <typename K, typename V>
+class WriteAheadLog {
+private:
+	static constexpr std::size_t kRecordHeaderSize = 8;
+
+	std::mutex mutex;
+	std::condition_variable flushed;
+	std::string path;
+	std::FILE* file = nullptr;
+	bool syncOnCommit = true;
+	std::string pending;        // 已追加但还没有写出的记录
+	std::uint64_t appended = 0; // 最后一条追加的记录的序号
+	std::uint64_t durable = 0;  // 此序号及之前的记录已经处理完（写出成功或失败）
+	std::uint64_t written = 0;  // 此序号及之前的记录已经成功落盘
+	bool flushing = false;      // 是否有线程正在锁外写文件
+	bool healthy = true;
+	std::uint64_t syncCount = 0;
+	std::size_t replayedRecords = 0;
+
+	static void encodeRecord(std::string& out, WalOp op, const K& key, const V* value);
+
+	// 重放 path 中的记录，遇到截断或校验失败的记录时丢弃它及之后的内容
+	template <typename Apply>
+	static bool replayFile(const std::string& path, Apply& apply, std::size_t& records);
+
+public:
+	WriteAheadLog() = default;
+
+	~WriteAheadLog() {
+		close();
+	}
+
+	WriteAheadLog(const WriteAheadLog&) = delete;
+	WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+	// 先把已有的记录按顺序交给 apply(WalOp, const K&, const V&)（Remove 时值为默认构造），
+	// 再打开文件用于追加；文件不存在时新建。sync 为 false 时 commit 只写入操作系统缓存，
+	// 进程崩溃不丢数据但掉电可能丢失最近的记录。无法读写文件时返回 false
+	template <typename Apply>
+	bool open(const std::string& logPath, Apply&& apply, bool sync = true);
+
+	// 写出尚未写出的记录并关闭文件
+	void close();
+
+	bool isOpen() const {
+		return file != nullptr;
+	}
+
+	std::uint64_t appendPut(const K& key, const V& value);
+
+	std::uint64_t appendRemove(const K& key);
+
+	// 等待序号 sequence 及之前的记录落盘，成功返回 true。这条记录所在的一批写出失败时返回 false
+	bool commit(std::uint64_t sequence);
+
+	// 丢弃全部记录并清空文件，sync 模式下返回 true 时截断已经落盘。
+	// 调用方保证这些记录的效果已经保存在快照中，且期间没有并发的 append
+	bool reset();
+
+	// 上次打开时重放的记录数
+	std::size_t replayed() const {
+		return replayedRecords;
+	}
+
+	// 实际写文件（并 fsync）的次数，用于观察组提交的效果
+	std::uint64_t syncs() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return syncCount;
+	}
+};
+
+template <typename K, typename V>
+void WriteAheadLog<K, V>::encodeRecord(std::string& out, WalOp op, const K& key, const V* value) {
+	std::size_t start = out.size();
+	out.append(kRecordHeaderSize, '\0');
+	out.push_back(static_cast<char>(op));
+	Serializer<K>::write(out, key);
+	if (value != nullptr) {
+		Serializer<V>::write(out, *value);
+	}
+
+	const char* payload = out.data() + start + kRecordHeaderSize;
+	std::size_t payloadSize = out.size() - start - kRecordHeaderSize;
+	std::string header;
+	Serializer<std::uint32_t>::write(header, static_cast<std::uint32_t>(payloadSize));
+	Serializer<std::uint32_t>::write(header, detail::crc32(payload, payloadSize));
+	out.replace(start, kRecordHeaderSize, header);
+}
+
+template <typename K, typename V>
+template <typename Apply>
+bool WriteAheadLog<K, V>::replayFile(const std::string& path, Apply& apply, std::size_t& records) {
+	records = 0;
+	std::error_code error;
+	if (!std::filesystem::exists(path, error)) {
+		return !error;
+	}
+
+	std::string contents;
+	if (!detail::readFile(path, contents)) {
+		return false;
+	}
+	const char* begin = contents.data();
+	const char* end = begin + contents.size();
+	const char* cursor = begin;
+	while (static_cast<std::size_t>(end - cursor) >= kRecordHeaderSize) {
+		const char* record = cursor;
+		std::uint32_t payloadSize = 0;
+		std::uint32_t checksum = 0;
+		Serializer<std::uint32_t>::read(cursor, end, payloadSize);
+		Serializer<std::uint32_t>::read(cursor, end, checksum);
+		if (payloadSize == 0 || payloadSize > static_cast<std::size_t>(end - cursor) ||
+			detail::crc32(cursor, payloadSize) != checksum) {
+			cursor = record;
+			break;
+		}
+
+		const char* payloadEnd = cursor + payloadSize;
+		auto op = static_cast<WalOp>(*cursor++);
+		K key{};
+		V value{};
+		bool valid = (op == WalOp::Put || op == WalOp::Remove) &&
+					 Serializer<K>::read(cursor, payloadEnd, key) &&
+					 (op == WalOp::Remove || Serializer<V>::read(cursor, payloadEnd, value)) &&
+					 cursor == payloadEnd;
+		if (!valid) {
+			cursor = record;
+			break;
+		}
+		apply(op, static_cast<const K&>(key), static_cast<const V&>(value));
+		records++;
+	}
+
+	// 崩溃时最后一条记录可能只写了一半。截掉它，之后追加的记录才能被重放
+	if (cursor != end) {
+		std::filesystem::resize_file(path, static_cast<std::uintmax_t>(cursor - begin), error);
+		if (error) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename K, typename V>
+template <typename Apply>
+bool WriteAheadLog<K, V>::open(const std::string& logPath, Apply&& apply, bool sync) {
+	close();
+	if (!replayFile(logPath, apply, replayedRecords)) {
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	flushed.wait(lock, [this] { return !flushing; });
+	file = std::fopen(logPath.c_str(), "ab");
+	if (file == nullptr) {
+		return false;
+	}
+	path = logPath;
+	syncOnCommit = sync;
+	pending.clear();
+	appended = 0;
+	durable = 0;
+	written = 0;
+	healthy = true;
+	return true;
+}
+
+template <typename K, typename V>
+void WriteAheadLog<K, V>::close() {
+	std::uint64_t last = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		last = appended;
+	}
+	commit(last);
+	std::unique_lock<std::mutex> lock(mutex);
+	flushed.wait(lock, [this] { return !flushing; });
+	if (file != nullptr) {
+		std::fclose(file);
+		file = nullptr;
+	}
+}
+
+template <typename K, typename V>
+std::uint64_t WriteAheadLog<K, V>::appendPut(const K& key, const V& value) {
+	std::lock_guard<std::mutex> lock(mutex);
+	encodeRecord(pending, WalOp::Put, key, &value);
+	return ++appended;
+}
+
+template <typename K, typename V>
+std::uint64_t WriteAheadLog<K, V>::appendRemove(const K& key) {
+	std::lock_guard<std::mutex> lock(mutex);
+	encodeRecord(pending, WalOp::Remove, key, nullptr);
+	return ++appended;
+}
+
+template <typename K, typename V>
+bool WriteAheadLog<K, V>::commit(std::uint64_t sequence) {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (durable < sequence) {
+		if (flushing) {
+			flushed.wait(lock);
+			continue;
+		}
+
+		// 成为 leader：带走目前为止所有线程追加的记录，在锁外写出，期间其他线程可以继续追加。
+		// 文件句柄和状态在锁内取出，flushing 为 true 期间 close/reset 不会替换它们
+		flushing = true;
+		std::string batch;
+		batch.swap(pending);
+		std::uint64_t target = appended;
+		std::FILE* out = healthy ? file : nullptr;
+		bool sync = syncOnCommit;
+		lock.unlock();
+
+		bool ok = out != nullptr &&
+				  std::fwrite(batch.data(), 1, batch.size(), out) == batch.size() &&
+				  (sync ? detail::syncFile(out) : std::fflush(out) == 0);
+
+		lock.lock();
+		flushing = false;
+		healthy = healthy && ok;
+		durable = target;
+		if (ok) {
+			written = target;
+		}
+		syncCount++;
+		flushed.notify_all();
+	}
+	return sequence <= written;
+}
+
+template <typename K, typename V>
+bool WriteAheadLog<K, V>::reset() {
+	std::unique_lock<std::mutex> lock(mutex);
+	flushed.wait(lock, [this] { return !flushing; });
+	if (file == nullptr) {
+		return false;
+	}
+
+	pending.clear();
+	durable = appended;
+	written = appended;
+	std::fclose(file);
+	std::error_code error;
+	std::filesystem::resize_file(path, 0, error);
+	file = std::fopen(path.c_str(), "ab");
+	// 截断本身也要落盘，否则掉电后旧记录可能重新出现，叠加在更新的快照上。
+	// 文件没有重新创建，目录项不变，只需 fsync 文件
+	healthy = !error && file != nullptr && (!syncOnCommit || detail::syncFile(file));
+	flushed.notify_all();
+	return healthy;
+}
+
+} // namespace skiplist
+
+#endif // WAL_HPP
@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_skiplist.hpp"
+
+// 无锁跳表测试，沿用 ConcurrentSkipListTest 的结构
+class LockFreeSkipListTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		sl = new skiplist::ConcurrentSkipList<int, std::string>(16);
+	}
+
+	void TearDown() override {
+		delete sl;
+	}
+
+	skiplist::ConcurrentSkipList<int, std::string>* sl;
+};
+
+TEST_F(LockFreeSkipListTest, InsertSearchRemove) {
+	EXPECT_TRUE(sl->insert(5, "five"));
+	EXPECT_TRUE(sl->insert(10, "ten"));
+	EXPECT_TRUE(sl->insert(3, "three"));
+	EXPECT_FALSE(sl->insert(5, "five_duplicate"));
+
+	auto value = sl->search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
+	EXPECT_FALSE(sl->search(7).has_value());
+
+	EXPECT_TRUE(sl->remove(5));
+	EXPECT_FALSE(sl->remove(5));
+	EXPECT_FALSE(sl->contains(5));
+	EXPECT_TRUE(sl->contains(10));
+	EXPECT_TRUE(sl->contains(3));
+	EXPECT_EQ(sl->size(), 2);
+}
+
+// 不相交键的并发插入：所有插入都必须成功且可见
+TEST_F(LockFreeSkipListTest, ConcurrentDisjointInsert) {
+	const int num_threads = 8;
+	const int inserts_per_thread = 2000;
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, i, inserts_per_thread]() {
+			for (int j = 0; j < inserts_per_thread; j++) {
+				int key = j * num_threads + i; // 交错的键，制造相邻位置上的竞争
+				EXPECT_TRUE(sl->insert(key, std::to_string(key)));
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(sl->size(), num_threads * inserts_per_thread);
+	EXPECT_EQ(sl->levelHistogram()[0], num_threads * inserts_per_thread);
+	for (int key = 0; key < num_threads * inserts_per_thread; key++) {
+		auto value = sl->search(key);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, std::to_string(key));
+	}
+}
+
+// 同一批键的并发插入/删除：每个键恰好只有一个线程成功
+TEST_F(LockFreeSkipListTest, ConcurrentSameKeyExactlyOnce) {
+	const int num_threads = 8;
+	const int num_keys = 2000;
+	std::atomic<int> insert_success{0};
+	std::atomic<int> remove_success{0};
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, num_keys, &insert_success]() {
+			for (int key = 0; key < num_keys; key++) {
+				if (sl->insert(key, std::to_string(key))) {
+					insert_success.fetch_add(1);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(insert_success.load(), num_keys);
+	EXPECT_EQ(sl->size(), num_keys);
+
+	threads.clear();
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, num_keys, &remove_success]() {
+			for (int key = 0; key < num_keys; key++) {
+				if (sl->remove(key)) {
+					remove_success.fetch_add(1);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(remove_success.load(), num_keys);
+	EXPECT_EQ(sl->size(), 0);
+	EXPECT_TRUE(sl->empty());
+	for (int count : sl->levelHistogram()) {
+		EXPECT_EQ(count, 0);
+	}
+}
+
+// 线性一致性检查：对每个键统计成功的插入/删除次数，
+// 最终是否存在必须等于 (成功插入 - 成功删除)，且该差值只能是 0 或 1
+TEST_F(LockFreeSkipListTest, LinearizableMixedWorkload) {
+	const int num_threads = 8;
+	const int operations_per_thread = 20000;
+	const int key_range = 256; // 小键空间，制造高冲突
+	std::vector<std::atomic<int>> balance(key_range);
+	for (auto& b : balance) {
+		b.store(0);
+	}
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, i, operations_per_thread, key_range, &balance]() {
+			std::mt19937 gen(i);
+			std::uniform_int_distribution<> dis(0, key_range - 1);
+			for (int j = 0; j < operations_per_thread; j++) {
+				int key = dis(gen);
+				switch (gen() % 3) {
+				case 0:
+					if (sl->insert(key, std::to_string(key))) {
+						balance[key].fetch_add(1);
+					}
+					break;
+				case 1: {
+					// 读到的值必须与键匹配，不能读到半初始化或已释放的节点
+					auto value = sl->search(key);
+					if (value.has_value()) {
+						EXPECT_EQ(*value, std::to_string(key));
+					}
+					break;
+				}
+				case 2:
+					if (sl->remove(key)) {
+						balance[key].fetch_sub(1);
+					}
+					break;
+				}
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	int expected_size = 0;
+	for (int key = 0; key < key_range; key++) {
+		int b = balance[key].load();
+		ASSERT_TRUE(b == 0 || b == 1) << "key " << key << " balance " << b;
+		EXPECT_EQ(sl->contains(key), b == 1) << "key " << key;
+		expected_size += b;
+	}
+	EXPECT_EQ(sl->size(), expected_size);
+}
+
+// 读线程与写线程并发：始终存在的键必须一直能被读到
+TEST_F(LockFreeSkipListTest, ReadersSeeStableKeysDuringChurn) {
+	const int stable_keys = 500;
+	for (int i = 0; i < stable_keys; i++) {
+		sl->insert(i * 2, "stable");
+	}
+
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> writers;
+	for (int i = 0; i < 4; i++) {
+		writers.emplace_back([this, i, &stop]() {
+			std::mt19937 gen(100 + i);
+			while (!stop.load()) {
+				int key = static_cast<int>(gen() % stable_keys) * 2 + 1; // 只动奇数键
+				if (gen() % 2 == 0) {
+					sl->insert(key, "churn");
+				} else {
+					sl->remove(key);
+				}
+			}
+		});
+	}
+
+	std::vector<std::thread> readers;
+	std::atomic<int> missing{0};
+	for (int i = 0; i < 4; i++) {
+		readers.emplace_back([this, &missing]() {
+			for (int round = 0; round < 20; round++) {
+				for (int key = 0; key < stable_keys * 2; key += 2) {
+					if (!sl->contains(key)) {
+						missing.fetch_add(1);
+					}
+				}
+			}
+		});
+	}
+
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	stop.store(true);
+	for (auto& writer : writers) {
+		writer.join();
+	}
+
+	EXPECT_EQ(missing.load(), 0);
+}
+
+// 弱一致性扫描：并发修改下依然严格有序，且始终存在的键一定被访问到
+TEST_F(LockFreeSkipListTest, WeaklyConsistentScan) {
+	for (int i = 0; i < 1000; i += 2) {
+		sl->insert(i, "stable");
+	}
+
+	std::atomic<bool> stop{false};
+	std::thread writer([this, &stop]() {
+		std::mt19937 gen(7);
+		while (!stop.load()) {
+			int key = static_cast<int>(gen() % 500) * 2 + 1;
+			if (gen() % 2 == 0) {
+				sl->insert(key, "churn");
+			} else {
+				sl->remove(key);
+			}
+		}
+	});
+
+	for (int round = 0; round < 50; round++) {
+		int previous = -1;
+		int stable = 0;
+		auto check = [&previous, &stable](const int& key, const std::string&) {
+			EXPECT_GT(key, previous);
+			previous = key;
+			if (key % 2 == 0) {
+				stable++;
+			}
+		};
+		size_t visited = sl->scan(0, 1000, check);
+		EXPECT_EQ(stable, 500);
+		EXPECT_GE(visited, 500u);
+	}
+
+	stop.store(true);
+	writer.join();
+
+	std::vector<int> firstThree;
+	sl->scan(0, 1000, [&firstThree](const int& key, const std::string&) {
+		firstThree.push_back(key);
+		return firstThree.size() < 3;
+	});
+	EXPECT_EQ(firstThree.size(), 3u);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_skiplist.hpp"
+#include "epoch.hpp"
+
+namespace {
+
+// 析构时计数，用来观察对象何时被真正释放
+struct Tracked {
+	static std::atomic<int> destroyed;
+	~Tracked() {
+		destroyed.fetch_add(1);
+	}
+};
+
+std::atomic<int> Tracked::destroyed{0};
+
+} // namespace
+
+class EpochManagerTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		Tracked::destroyed.store(0);
+	}
+};
+
+TEST_F(EpochManagerTest, RetiredObjectsFreedAfterTwoEpochs) {
+	skiplist::EpochManager epochs;
+	{
+		auto guard = epochs.pin();
+		epochs.retire(new Tracked());
+	}
+	EXPECT_EQ(Tracked::destroyed.load(), 0);
+
+	// 没有线程在临界区，连续推进两次纪元后即可回收
+	epochs.collect();
+	epochs.collect();
+	epochs.collect();
+	EXPECT_EQ(Tracked::destroyed.load(), 1);
+}
+
+TEST_F(EpochManagerTest, PinnedReaderBlocksReclamation) {
+	skiplist::EpochManager epochs;
+	std::atomic<bool> pinned{false};
+	std::atomic<bool> release{false};
+
+	std::thread reader([&]() {
+		auto guard = epochs.pin();
+		pinned.store(true);
+		while (!release.load()) {
+			std::this_thread::yield();
+		}
+	});
+	while (!pinned.load()) {
+		std::this_thread::yield();
+	}
+
+	epochs.retire(new Tracked());
+	for (int i = 0; i < 10; i++) {
+		epochs.collect();
+	}
+	// 读者停留在旧纪元，纪元最多只能前进一步
+	EXPECT_EQ(Tracked::destroyed.load(), 0);
+
+	release.store(true);
+	reader.join();
+	for (int i = 0; i < 3; i++) {
+		epochs.collect();
+	}
+	EXPECT_EQ(Tracked::destroyed.load(), 1);
+}
+
+TEST_F(EpochManagerTest, NestedGuards) {
+	skiplist::EpochManager epochs;
+	{
+		auto outer = epochs.pin();
+		{
+			auto inner = epochs.pin();
+		}
+		// 内层守卫退出后仍处于临界区
+		epochs.retire(new Tracked());
+		epochs.collect();
+		epochs.collect();
+		epochs.collect();
+		EXPECT_EQ(Tracked::destroyed.load(), 0);
+	}
+	epochs.collect();
+	epochs.collect();
+	EXPECT_EQ(Tracked::destroyed.load(), 1);
+}
+
+TEST_F(EpochManagerTest, BatchedReclamationOnRetire) {
+	skiplist::EpochManager epochs;
+	const int count = 10000;
+	for (int i = 0; i < count; i++) {
+		epochs.retire(new Tracked());
+	}
+	// 退休过程中会按批次推进纪元，绝大部分对象无需等到析构
+	EXPECT_GT(Tracked::destroyed.load(), count / 2);
+}
+
+TEST_F(EpochManagerTest, DestructorFreesPendingAndExitedThreads) {
+	{
+		skiplist::EpochManager epochs;
+		std::vector<std::thread> threads;
+		for (int i = 0; i < 4; i++) {
+			threads.emplace_back([&epochs]() {
+				auto guard = epochs.pin();
+				epochs.retire(new Tracked());
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		epochs.retire(new Tracked());
+	}
+	EXPECT_EQ(Tracked::destroyed.load(), 5);
+}
+
+// 持有守卫期间，lookup 返回的指针在键被并发删除后仍然有效
+TEST(ConcurrentSkipListReclamationTest, PinnedLookupSurvivesConcurrentRemove) {
+	skiplist::ConcurrentSkipList<int, std::string> sl(16);
+	for (int i = 0; i < 1000; i++) {
+		sl.insert(i, "value_" + std::to_string(i));
+	}
+
+	auto guard = sl.pin();
+	const std::string* value = sl.lookup(42, guard);
+	ASSERT_NE(value, nullptr);
+
+	std::thread remover([&sl]() {
+		// 大量删除以触发多轮批量回收
+		for (int i = 0; i < 1000; i++) {
+			sl.remove(i);
+		}
+		for (int i = 0; i < 1000; i++) {
+			sl.insert(i, "again");
+			sl.remove(i);
+		}
+	});
+	remover.join();
+
+	EXPECT_FALSE(sl.contains(42));
+	EXPECT_EQ(*value, "value_42");
+}
+
+TEST(ConcurrentSkipListReclamationTest, ChurnWithReaders) {
+	skiplist::ConcurrentSkipList<int, std::string> sl(16);
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < 3; i++) {
+		threads.emplace_back([&sl, i]() {
+			for (int round = 0; round < 20; round++) {
+				for (int key = i; key < 600; key += 3) {
+					sl.insert(key, std::to_string(key));
+				}
+				for (int key = i; key < 600; key += 3) {
+					sl.remove(key);
+				}
+			}
+		});
+	}
+	std::thread reader([&sl, &stop]() {
+		while (!stop.load()) {
+			for (int key = 0; key < 600; key++) {
+				auto guard = sl.pin();
+				const std::string* value = sl.lookup(key, guard);
+				if (value != nullptr) {
+					EXPECT_EQ(*value, std::to_string(key));
+				}
+			}
+		}
+	});
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	stop.store(true);
+	reader.join();
+	EXPECT_EQ(sl.size(), 0);
+}
@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fine_grained_skiplist.hpp"
+
+// 细粒度锁跳表测试，沿用 LockFreeSkipListTest 的结构
+class FineGrainedSkipListTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		sl = new skiplist::FineGrainedSkipList<int, std::string>(16);
+	}
+
+	void TearDown() override {
+		delete sl;
+	}
+
+	skiplist::FineGrainedSkipList<int, std::string>* sl;
+};
+
+TEST_F(FineGrainedSkipListTest, InsertSearchRemove) {
+	EXPECT_TRUE(sl->insert(5, "five"));
+	EXPECT_TRUE(sl->insert(10, "ten"));
+	EXPECT_TRUE(sl->insert(3, "three"));
+	EXPECT_FALSE(sl->insert(5, "five_duplicate"));
+
+	auto value = sl->search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
+	EXPECT_FALSE(sl->search(7).has_value());
+
+	EXPECT_TRUE(sl->remove(5));
+	EXPECT_FALSE(sl->remove(5));
+	EXPECT_FALSE(sl->contains(5));
+	EXPECT_TRUE(sl->contains(10));
+	EXPECT_TRUE(sl->contains(3));
+	EXPECT_EQ(sl->size(), 2);
+
+	{
+		auto guard = sl->pin();
+		const std::string* ten = sl->lookup(10, guard);
+		ASSERT_NE(ten, nullptr);
+		EXPECT_EQ(*ten, "ten");
+		EXPECT_EQ(sl->lookup(11, guard), nullptr);
+	}
+}
+
+// 不相交键的并发插入：所有插入都必须成功且可见
+TEST_F(FineGrainedSkipListTest, ConcurrentDisjointInsert) {
+	const int num_threads = 8;
+	const int inserts_per_thread = 2000;
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, i, inserts_per_thread]() {
+			for (int j = 0; j < inserts_per_thread; j++) {
+				int key = j * num_threads + i; // 交错的键，相邻的键共用前驱，制造锁竞争
+				EXPECT_TRUE(sl->insert(key, std::to_string(key)));
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(sl->size(), num_threads * inserts_per_thread);
+	EXPECT_EQ(sl->levelHistogram()[0], num_threads * inserts_per_thread);
+	int previous = -1;
+	sl->scan(0, num_threads * inserts_per_thread, [&previous](const int& key, const std::string&) {
+		EXPECT_EQ(key, previous + 1);
+		previous = key;
+	});
+	EXPECT_EQ(previous, num_threads * inserts_per_thread - 1);
+}
+
+// 同一批键的并发插入/删除：每个键恰好只有一个线程成功
+TEST_F(FineGrainedSkipListTest, ConcurrentSameKeyExactlyOnce) {
+	const int num_threads = 8;
+	const int num_keys = 2000;
+	std::atomic<int> insert_success{0};
+	std::atomic<int> remove_success{0};
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, num_keys, &insert_success]() {
+			for (int key = 0; key < num_keys; key++) {
+				if (sl->insert(key, std::to_string(key))) {
+					insert_success.fetch_add(1);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(insert_success.load(), num_keys);
+	EXPECT_EQ(sl->size(), num_keys);
+
+	threads.clear();
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, num_keys, &remove_success]() {
+			for (int key = 0; key < num_keys; key++) {
+				if (sl->remove(key)) {
+					remove_success.fetch_add(1);
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	EXPECT_EQ(remove_success.load(), num_keys);
+	EXPECT_TRUE(sl->empty());
+	for (int count : sl->levelHistogram()) {
+		EXPECT_EQ(count, 0);
+	}
+}
+
+// 线性一致性检查：每个键成功插入次数减成功删除次数只能是 0 或 1，且与最终是否存在一致
+TEST_F(FineGrainedSkipListTest, LinearizableMixedWorkload) {
+	const int num_threads = 8;
+	const int operations_per_thread = 20000;
+	const int key_range = 256; // 小键空间，制造高冲突
+	std::vector<std::atomic<int>> balance(key_range);
+	for (auto& b : balance) {
+		b.store(0);
+	}
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < num_threads; i++) {
+		threads.emplace_back([this, i, operations_per_thread, key_range, &balance]() {
+			std::mt19937 gen(i);
+			std::uniform_int_distribution<> dis(0, key_range - 1);
+			for (int j = 0; j < operations_per_thread; j++) {
+				int key = dis(gen);
+				switch (gen() % 3) {
+				case 0:
+					if (sl->insert(key, std::to_string(key))) {
+						balance[key].fetch_add(1);
+					}
+					break;
+				case 1: {
+					auto value = sl->search(key);
+					if (value.has_value()) {
+						EXPECT_EQ(*value, std::to_string(key));
+					}
+					break;
+				}
+				case 2:
+					if (sl->remove(key)) {
+						balance[key].fetch_sub(1);
+					}
+					break;
+				}
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	int expected_size = 0;
+	for (int key = 0; key < key_range; key++) {
+		int b = balance[key].load();
+		ASSERT_TRUE(b == 0 || b == 1) << "key " << key << " balance " << b;
+		EXPECT_EQ(sl->contains(key), b == 1) << "key " << key;
+		expected_size += b;
+	}
+	EXPECT_EQ(sl->size(), expected_size);
+}
+
+// 读线程不加锁：写线程并发修改相邻的键时，始终存在的键必须一直能被读到，扫描严格有序
+TEST_F(FineGrainedSkipListTest, LockFreeReadersDuringChurn) {
+	const int stable_keys = 500;
+	for (int i = 0; i < stable_keys; i++) {
+		sl->insert(i * 2, "stable");
+	}
+
+	std::atomic<bool> stop{false};
+	std::vector<std::thread> writers;
+	for (int i = 0; i < 4; i++) {
+		writers.emplace_back([this, i, &stop]() {
+			std::mt19937 gen(100 + i);
+			while (!stop.load()) {
+				int key = static_cast<int>(gen() % stable_keys) * 2 + 1; // 只动奇数键
+				if (gen() % 2 == 0) {
+					sl->insert(key, "churn");
+				} else {
+					sl->remove(key);
+				}
+			}
+		});
+	}
+
+	std::atomic<int> missing{0};
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 2; i++) {
+		readers.emplace_back([this, &missing]() {
+			for (int round = 0; round < 20; round++) {
+				for (int key = 0; key < stable_keys * 2; key += 2) {
+					if (!sl->contains(key)) {
+						missing.fetch_add(1);
+					}
+				}
+			}
+		});
+	}
+	for (int round = 0; round < 20; round++) {
+		int previous = -1;
+		int stable = 0;
+		sl->scan(0, stable_keys * 2, [&previous, &stable](const int& key, const std::string&) {
+			EXPECT_GT(key, previous);
+			previous = key;
+			stable += key % 2 == 0;
+		});
+		EXPECT_EQ(stable, stable_keys);
+	}
+
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	stop.store(true);
+	for (auto& writer : writers) {
+		writer.join();
+	}
+	EXPECT_EQ(missing.load(), 0);
+}
+
+TEST(FineGrainedSkipListCompareTest, CustomComparator) {
+	skiplist::FineGrainedSkipList<int, int, std::greater<int>> sl(16);
+	for (int i = 0; i < 100; i++) {
+		sl.insert(i, i * i);
+	}
+	std::vector<int> keys;
+	sl.scan(50, 44, [&keys](const int& key, const int&) { keys.push_back(key); });
+	EXPECT_EQ(keys, (std::vector<int>{50, 49, 48, 47, 46, 45}));
+	EXPECT_EQ(*sl.search(9), 81);
+}
+
+// 拷贝时可以按需抛出异常的值
+struct ThrowingValue {
+	static inline bool throwOnCopy = false;
+	int value = 0;
+
+	ThrowingValue() = default;
+	explicit ThrowingValue(int v) : value(v) {}
+	ThrowingValue(const ThrowingValue& other) : value(other.value) {
+		if (throwOnCopy) {
+			throw std::runtime_error("copy failed");
+		}
+	}
+	ThrowingValue& operator=(const ThrowingValue&) = default;
+};
+
+// 构造节点时抛出的异常不会留下锁住的前驱，之后相邻位置的插入照常完成
+TEST(FineGrainedSkipListExceptionTest, ThrowingCopyLeavesNoLocksHeld) {
+	skiplist::FineGrainedSkipList<int, ThrowingValue> sl(16);
+	for (int i = 0; i < 100; i += 2) {
+		EXPECT_TRUE(sl.insert(i, ThrowingValue(i)));
+	}
+
+	ThrowingValue::throwOnCopy = true;
+	EXPECT_THROW(sl.insert(51, ThrowingValue(51)), std::runtime_error);
+	ThrowingValue::throwOnCopy = false;
+
+	EXPECT_FALSE(sl.contains(51));
+	for (int i = 1; i < 100; i += 2) {
+		EXPECT_TRUE(sl.insert(i, ThrowingValue(i)));
+	}
+	EXPECT_EQ(sl.size(), 100);
+}
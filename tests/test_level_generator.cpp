@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "level_generator.hpp"
+#include "skiplist.hpp"
+
+namespace {
+
+// 对 generate() 抽样 samples 次，检验层高是否服从 P(level = i) = (1 - p) p^i（在 maxLevel 处截断）。
+// 期望计数过小的尾部合并成一组后做卡方检验，临界值取得很宽，避免随机种子导致偶发失败
+template <typename Generate>
+void expectGeometric(Generate generate, double p, int maxLevel, int samples) {
+	std::vector<int> observed(maxLevel + 1, 0);
+	for (int i = 0; i < samples; i++) {
+		int level = generate();
+		ASSERT_GE(level, 0);
+		ASSERT_LE(level, maxLevel);
+		observed[level]++;
+	}
+
+	std::vector<double> expected(maxLevel + 1);
+	for (int i = 0; i <= maxLevel; i++) {
+		double atLeast = std::pow(p, i);
+		expected[i] = samples * (i == maxLevel ? atLeast : atLeast * (1 - p));
+	}
+
+	double chiSquare = 0;
+	int groups = 0;
+	double tailExpected = 0;
+	double tailObserved = 0;
+	for (int i = 0; i <= maxLevel; i++) {
+		if (expected[i] >= 50) {
+			double diff = observed[i] - expected[i];
+			chiSquare += diff * diff / expected[i];
+			groups++;
+		} else {
+			tailExpected += expected[i];
+			tailObserved += observed[i];
+		}
+	}
+	if (tailExpected > 0) {
+		double diff = tailObserved - tailExpected;
+		chiSquare += diff * diff / tailExpected;
+		groups++;
+	}
+
+	// 自由度 groups - 1，卡方分布的均值为 k、标准差为 sqrt(2k)，取均值加 7 个标准差
+	double degrees = groups - 1;
+	EXPECT_LT(chiSquare, degrees + 7 * std::sqrt(2 * degrees)) << "p = " << p;
+}
+
+} // namespace
+
+TEST(LevelGeneratorTest, DistributionMatchesHalf) {
+	skiplist::detail::LevelGenerator generator(0.5f, 32);
+	expectGeometric(generator, 0.5, 32, 200000);
+}
+
+TEST(LevelGeneratorTest, DistributionMatchesQuarter) {
+	skiplist::detail::LevelGenerator generator(0.25f, 16);
+	expectGeometric(generator, 0.25, 16, 200000);
+}
+
+// 不是 2 的负整数次幂的 p 走逐层比较的通用路径
+TEST(LevelGeneratorTest, DistributionMatchesArbitraryP) {
+	skiplist::detail::LevelGenerator generator(0.3f, 16);
+	expectGeometric(generator, 0.3f, 16, 200000);
+}
+
+TEST(LevelGeneratorTest, RespectsMaxLevelAndDegenerateP) {
+	skiplist::detail::LevelGenerator capped(0.5f, 2);
+	skiplist::detail::LevelGenerator never(0.0f, 16);
+	skiplist::detail::LevelGenerator always(1.0f, 5);
+	for (int i = 0; i < 10000; i++) {
+		EXPECT_LE(capped(), 2);
+		EXPECT_EQ(never(), 0);
+		EXPECT_EQ(always(), 5);
+	}
+}
+
+// 跳表自己的 getRandomLevel 与多线程下各自的生成器
+TEST(LevelGeneratorTest, SkipListLevelsFromManyThreads) {
+	skiplist::SkipList<int, int> sl(16, 0.25f);
+	expectGeometric([&sl]() { return sl.getRandomLevel(); }, 0.25, 16, 100000);
+
+	std::atomic<int> levelOneOrMore{0};
+	std::vector<std::thread> threads;
+	const int perThread = 50000;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&sl, &levelOneOrMore]() {
+			int count = 0;
+			for (int i = 0; i < perThread; i++) {
+				count += sl.getRandomLevel() >= 1;
+			}
+			levelOneOrMore.fetch_add(count);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	// 4 * 50000 次抽样，期望 50000 次升到第 1 层，标准差约 194
+	EXPECT_NEAR(levelOneOrMore.load(), 50000, 2000);
+}
@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapped_skiplist.hpp"
+#include "skiplist.hpp"
+#include "unrolled_skiplist.hpp"
+
+namespace {
+
+std::string imagePath(const char* name) {
+	return ::testing::TempDir() + name;
+}
+
+} // namespace
+
+// 由 SkipList 生成映像，查找、遍历和边界与 std::map 一致
+TEST(MappedSkipListTest, MatchesSourceSkipList) {
+	std::string path = imagePath("mapped_random.bin");
+	skiplist::SkipList<std::int64_t, std::string> source(16);
+	std::map<std::int64_t, std::string> reference;
+	std::mt19937_64 gen(5);
+	for (int i = 0; i < 5000; i++) {
+		auto key = static_cast<std::int64_t>(gen() % 100000) - 50000;
+		source.insert(key, std::to_string(key));
+		reference.emplace(key, std::to_string(key));
+	}
+	ASSERT_TRUE((skiplist::MappedSkipList<std::int64_t, std::string>::build(path, source)));
+
+	skiplist::MappedSkipList<std::int64_t, std::string> mapped;
+	ASSERT_TRUE(mapped.open(path));
+	ASSERT_EQ(mapped.size(), static_cast<int>(reference.size()));
+
+	// 每层约为下一层的 1/4
+	std::vector<int> histogram = mapped.levelHistogram();
+	ASSERT_GT(histogram.size(), 1u);
+	for (std::size_t i = 1; i < histogram.size(); i++) {
+		EXPECT_EQ(histogram[i], histogram[i - 1] / 4);
+	}
+
+	auto expected = reference.begin();
+	for (auto it = mapped.begin(); it != mapped.end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->first);
+		EXPECT_EQ(it->value, expected->second);
+	}
+	EXPECT_EQ(expected, reference.end());
+
+	for (std::int64_t key = -50010; key <= 50010; key += 7) {
+		auto value = mapped.search(key);
+		auto found = reference.find(key);
+		ASSERT_EQ(value.has_value(), found != reference.end()) << key;
+		if (value.has_value()) {
+			EXPECT_EQ(*value, found->second);
+		}
+
+		auto lower = mapped.lower_bound(key);
+		auto referenceLower = reference.lower_bound(key);
+		if (referenceLower == reference.end()) {
+			EXPECT_EQ(lower, mapped.end());
+		} else {
+			ASSERT_NE(lower, mapped.end());
+			EXPECT_EQ(lower->key, referenceLower->first);
+		}
+
+		auto upper = mapped.upper_bound(key);
+		auto referenceUpper = reference.upper_bound(key);
+		if (referenceUpper == reference.end()) {
+			EXPECT_EQ(upper, mapped.end());
+		} else {
+			ASSERT_NE(upper, mapped.end());
+			EXPECT_EQ(upper->key, referenceUpper->first);
+		}
+	}
+	std::remove(path.c_str());
+}
+
+TEST(MappedSkipListTest, ScanAndSortedRange) {
+	std::string path = imagePath("mapped_scan.bin");
+	std::vector<std::pair<int, double>> sorted;
+	for (int i = 0; i < 100; i += 2) {
+		sorted.emplace_back(i, i * 0.5);
+	}
+	sorted.emplace_back(5, 0.0); // 不满足严格递增，被跳过
+	ASSERT_TRUE((skiplist::MappedSkipList<int, double>::build(path, sorted.begin(), sorted.end())));
+
+	skiplist::MappedSkipList<int, double> mapped;
+	ASSERT_TRUE(mapped.open(path));
+	EXPECT_EQ(mapped.size(), 50);
+	EXPECT_FALSE(mapped.contains(5));
+	EXPECT_TRUE(mapped.contains(98));
+	EXPECT_DOUBLE_EQ(*mapped.search(10), 5.0);
+
+	std::vector<int> keys;
+	std::size_t visited = mapped.scan(11, 21, [&keys](const int& key, const double& value) {
+		EXPECT_DOUBLE_EQ(value, key * 0.5);
+		keys.push_back(key);
+	});
+	EXPECT_EQ(visited, 5u);
+	EXPECT_EQ(keys, (std::vector<int>{12, 14, 16, 18, 20}));
+
+	keys.clear();
+	mapped.scan(0, 100, [&keys](const int& key, const double&) {
+		keys.push_back(key);
+		return keys.size() < 3;
+	});
+	EXPECT_EQ(keys.size(), 3u);
+	std::remove(path.c_str());
+}
+
+TEST(MappedSkipListTest, EmptyAndUnrolledSource) {
+	std::string path = imagePath("mapped_empty.bin");
+	skiplist::SkipList<int, int> empty;
+	ASSERT_TRUE((skiplist::MappedSkipList<int, int>::build(path, empty)));
+
+	skiplist::MappedSkipList<int, int> mapped;
+	ASSERT_TRUE(mapped.open(path));
+	EXPECT_TRUE(mapped.empty());
+	EXPECT_FALSE(mapped.search(1).has_value());
+	EXPECT_EQ(mapped.begin(), mapped.end());
+	EXPECT_EQ(mapped.lower_bound(0), mapped.end());
+
+	skiplist::UnrolledSkipList<int, int> unrolled;
+	for (int i = 0; i < 1000; i++) {
+		unrolled.insert(i, -i);
+	}
+	ASSERT_TRUE((skiplist::MappedSkipList<int, int>::build(path, unrolled)));
+	ASSERT_TRUE(mapped.open(path));
+	EXPECT_EQ(mapped.size(), 1000);
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_EQ(*mapped.search(i), -i);
+	}
+	// 另一个映像中相同位置的迭代器不相等
+	skiplist::MappedSkipList<int, int> other;
+	ASSERT_TRUE(other.open(path));
+	EXPECT_NE(mapped.begin(), other.begin());
+	EXPECT_NE(mapped.end(), other.end());
+	other.close();
+
+	mapped.close();
+	EXPECT_FALSE(mapped.isOpen());
+	std::remove(path.c_str());
+}
+
+// int 键的元素在键和 link 之间有 4 个填充字节，写进映像的填充字节全部为 0
+TEST(MappedSkipListTest, PaddingBytesAreZero) {
+	std::string path = imagePath("mapped_padding.bin");
+	skiplist::SkipList<int, int> source(16);
+	for (int i = 0; i < 100; i++) {
+		source.insert(i, i);
+	}
+	ASSERT_TRUE((skiplist::MappedSkipList<int, int>::build(path, source)));
+
+	std::ifstream in(path, std::ios::binary);
+	std::string image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	std::uint64_t offset = 0;
+	std::uint64_t count = 0;
+	std::memcpy(&offset, image.data() + 64, sizeof(offset)); // 层表的第一项是第 0 层
+	std::memcpy(&count, image.data() + 72, sizeof(count));
+	ASSERT_EQ(count, 100u);
+	constexpr std::size_t kSlotSize = 16;
+	ASSERT_LE(offset + count * kSlotSize, image.size());
+	for (std::uint64_t i = 0; i < count; i++) {
+		const char* padding = image.data() + offset + i * kSlotSize + sizeof(int);
+		EXPECT_EQ(std::string(padding, 4), std::string(4, '\0')) << i;
+	}
+	std::remove(path.c_str());
+}
+
+// 缺失、截断或格式不符的文件被拒绝，不会越界访问
+TEST(MappedSkipListTest, RejectsInvalidFiles) {
+	skiplist::MappedSkipList<int, std::string> mapped;
+	EXPECT_FALSE(mapped.open(imagePath("mapped_missing.bin")));
+
+	std::string path = imagePath("mapped_corrupt.bin");
+	skiplist::SkipList<int, std::string> source;
+	for (int i = 0; i < 100; i++) {
+		source.insert(i, std::to_string(i));
+	}
+	ASSERT_TRUE(source.saveTo(path)); // 普通快照不是映像
+	EXPECT_FALSE(mapped.open(path));
+
+	ASSERT_TRUE((skiplist::MappedSkipList<int, std::string>::build(path, source)));
+	std::string image;
+	{
+		std::ifstream in(path, std::ios::binary);
+		image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(image.data(), static_cast<std::streamsize>(image.size() - 3));
+	}
+	EXPECT_FALSE(mapped.open(path));
+
+	// 键的宽度不同的映像不能打开
+	ASSERT_TRUE((skiplist::MappedSkipList<int, std::string>::build(path, source)));
+	skiplist::MappedSkipList<std::int64_t, std::string> wider;
+	EXPECT_FALSE(wider.open(path));
+	ASSERT_TRUE(mapped.open(path));
+	EXPECT_EQ(*mapped.search(42), "42");
+	mapped.close();
+
+	// header 中的表偏移接近 2^64，相加会溢出
+	std::string overflowing = image;
+	std::uint64_t hugeOffset = ~std::uint64_t{0} - 8;
+	std::memcpy(&overflowing[48], &hugeOffset, sizeof(hugeOffset));
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(overflowing.data(), static_cast<std::streamsize>(overflowing.size()));
+	}
+	EXPECT_FALSE(mapped.open(path));
+	std::remove(path.c_str());
+}
+
+// 值区损坏时查找返回 std::nullopt，遍历和扫描在损坏的值处结束，而不是返回默认值
+TEST(MappedSkipListTest, StopsAtCorruptValue) {
+	std::string path = imagePath("mapped_corrupt_value.bin");
+	skiplist::SkipList<int, std::string> source;
+	for (int i = 0; i < 100; i++) {
+		source.insert(i, std::to_string(i));
+	}
+	ASSERT_TRUE((skiplist::MappedSkipList<int, std::string>::build(path, source)));
+	std::string image;
+	{
+		std::ifstream in(path, std::ios::binary);
+		image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	// 值区在文件末尾，最后一个值 "99" 编码为长度 2 加两个字符，把长度改成超出文件的 127
+	ASSERT_EQ(image.substr(image.size() - 3), std::string("\x02" "99"));
+	image[image.size() - 3] = 0x7f;
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(image.data(), static_cast<std::streamsize>(image.size()));
+	}
+
+	skiplist::MappedSkipList<int, std::string> mapped;
+	ASSERT_TRUE(mapped.open(path));
+	EXPECT_EQ(*mapped.search(98), "98");
+	EXPECT_FALSE(mapped.search(99).has_value());
+	EXPECT_EQ(std::distance(mapped.begin(), mapped.end()), 99);
+	EXPECT_EQ(mapped.lower_bound(99), mapped.end());
+
+	std::vector<int> keys;
+	mapped.scan(95, 200, [&keys](const int& key, const std::string&) { keys.push_back(key); });
+	EXPECT_EQ(keys, (std::vector<int>{95, 96, 97, 98}));
+	mapped.close();
+	std::remove(path.c_str());
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "memtable.hpp"
+
+using StringMemTable = skiplist::MemTable<std::string, std::string>;
+
+TEST(MemTableTest, ReadsAsOfSnapshot) {
+	StringMemTable table(16);
+	EXPECT_TRUE(table.put(1, "a", "a1"));
+	EXPECT_TRUE(table.put(2, "b", "b2"));
+	EXPECT_TRUE(table.put(3, "a", "a3"));
+	EXPECT_TRUE(table.remove(4, "a"));
+	EXPECT_TRUE(table.put(5, "a", "a5"));
+	EXPECT_FALSE(table.put(5, "a", "dup")); // (键, 序号) 已存在
+	EXPECT_EQ(table.size(), 5);
+
+	std::optional<std::string> value;
+	EXPECT_FALSE(table.get("a", 0, value)); // 快照早于所有版本
+	ASSERT_TRUE(table.get("a", 1, value));
+	EXPECT_EQ(value, "a1");
+	ASSERT_TRUE(table.get("a", 3, value));
+	EXPECT_EQ(value, "a3");
+	ASSERT_TRUE(table.get("a", 4, value));
+	EXPECT_EQ(value, std::nullopt); // 墓碑：已删除，不必再查更旧的数据
+	ASSERT_TRUE(table.get("a", 100, value));
+	EXPECT_EQ(value, "a5");
+
+	EXPECT_FALSE(table.get("b", 1, value));
+	EXPECT_EQ(table.get("b"), "b2");
+	EXPECT_FALSE(table.get("c", StringMemTable::kMaxSequence, value));
+	EXPECT_EQ(table.get("aa"), std::nullopt);
+	EXPECT_GT(table.approximateMemoryUsage(), 0u);
+}
+
+// 刷盘遍历按用户键升序、同一个键从新到旧输出全部版本和墓碑
+TEST(MemTableTest, FlushOrder) {
+	skiplist::MemTable<int, int> table(16);
+	table.put(10, 2, 20);
+	table.put(11, 1, 11);
+	table.remove(12, 2);
+	table.put(13, 1, 13);
+	table.put(14, 3, 30);
+
+	using Record = std::tuple<int, std::uint64_t, skiplist::ValueType>;
+	std::vector<Record> expected = {
+		{1, 13, skiplist::ValueType::Value},	{1, 11, skiplist::ValueType::Value},
+		{2, 12, skiplist::ValueType::Deletion}, {2, 10, skiplist::ValueType::Value},
+		{3, 14, skiplist::ValueType::Value},
+	};
+
+	std::vector<Record> visited;
+	table.forEach([&visited](const skiplist::InternalKey<int>& key, const int&) {
+		visited.emplace_back(key.userKey, key.sequence, key.type);
+	});
+	EXPECT_EQ(visited, expected);
+
+	std::vector<Record> iterated;
+	for (auto it = table.begin(); it != table.end(); ++it) {
+		iterated.emplace_back(it->key.userKey, it->key.sequence, it->key.type);
+	}
+	EXPECT_EQ(iterated, expected);
+}
+
+TEST(MemTableTest, CustomUserComparator) {
+	skiplist::MemTable<int, int, std::greater<int>> table(16);
+	for (int i = 0; i < 10; i++) {
+		table.put(static_cast<std::uint64_t>(i + 1), i, i);
+	}
+	table.put(100, 5, -5);
+	EXPECT_EQ(table.begin()->key.userKey, 9);
+	EXPECT_EQ(table.get(5), -5);
+
+	std::optional<int> value;
+	ASSERT_TRUE(table.get(5, 99, value));
+	EXPECT_EQ(value, 5);
+}
+
+// 拷贝时计数的用户键
+struct CountedKey {
+	static inline int copies = 0;
+	int id = 0;
+
+	CountedKey() = default;
+	explicit CountedKey(int i) : id(i) {}
+	CountedKey(const CountedKey& other) : id(other.id) {
+		copies++;
+	}
+	CountedKey& operator=(const CountedKey& other) {
+		id = other.id;
+		copies++;
+		return *this;
+	}
+
+	bool operator<(const CountedKey& other) const {
+		return id < other.id;
+	}
+};
+
+// 点查直接用查找视图比较，不拷贝用户键
+TEST(MemTableTest, GetDoesNotCopyUserKey) {
+	skiplist::MemTable<CountedKey, int> table(16);
+	for (int i = 0; i < 100; i++) {
+		table.put(static_cast<std::uint64_t>(i + 1), CountedKey(i), i);
+	}
+
+	CountedKey::copies = 0;
+	std::optional<int> value;
+	ASSERT_TRUE(table.get(CountedKey(42), 1000, value));
+	EXPECT_EQ(value, 42);
+	EXPECT_FALSE(table.get(CountedKey(42), 10, value));
+	EXPECT_EQ(CountedKey::copies, 0);
+}
+
+// 一个写线程按递增序号覆盖同一组键，读线程在已发布的序号上读取，结果必须与该序号一致
+TEST(MemTableTest, ConcurrentReadersSeeConsistentSnapshots) {
+	constexpr int kKeys = 64;
+	constexpr int kRounds = 100;
+	skiplist::MemTable<int, std::uint64_t> table(16);
+	std::atomic<std::uint64_t> published{0};
+
+	std::thread writer([&] {
+		std::uint64_t sequence = 0;
+		for (int round = 0; round < kRounds; round++) {
+			for (int key = 0; key < kKeys; key++) {
+				sequence++;
+				table.put(sequence, key, sequence);
+				published.store(sequence, std::memory_order_release);
+			}
+		}
+	});
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 3; r++) {
+		readers.emplace_back([&] {
+			for (int i = 0; i < 2000; i++) {
+				std::uint64_t snapshot = published.load(std::memory_order_acquire);
+				int key = i % kKeys;
+				std::optional<std::uint64_t> value;
+				if (table.get(key, snapshot, value)) {
+					ASSERT_TRUE(value.has_value());
+					EXPECT_LE(*value, snapshot);
+					// 本轮写过该键时读到本轮的版本，否则读到上一轮的版本
+					EXPECT_GT(*value + kKeys, snapshot);
+				} else {
+					EXPECT_LE(snapshot, static_cast<std::uint64_t>(key));
+				}
+			}
+		});
+	}
+
+	writer.join();
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	EXPECT_EQ(table.size(), kKeys * kRounds);
+	EXPECT_EQ(table.get(0), static_cast<std::uint64_t>((kRounds - 1) * kKeys + 1));
+}
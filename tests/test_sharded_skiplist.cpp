@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "sharded_skiplist.hpp"
+
+namespace {
+
+// 随机的插入/删除与 std::map 对照，再检查有序遍历、边界和范围扫描
+template <typename Sharded>
+void expectMatchesStdMap(Sharded& sl) {
+	std::map<int, int> reference;
+	std::mt19937 gen(3);
+	std::uniform_int_distribution<> dis(0, 1999);
+	for (int round = 0; round < 20000; round++) {
+		int key = dis(gen);
+		if (gen() % 3 != 0) {
+			EXPECT_EQ(sl.insert(key, key * 2), reference.emplace(key, key * 2).second);
+		} else {
+			EXPECT_EQ(sl.remove(key), reference.erase(key) == 1);
+		}
+	}
+
+	ASSERT_EQ(sl.size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (auto it = sl.begin(); it != sl.end(); ++it, ++expected) {
+		ASSERT_NE(expected, reference.end());
+		EXPECT_EQ(it->key, expected->first);
+		EXPECT_EQ(it->value, expected->second);
+	}
+	EXPECT_EQ(expected, reference.end());
+
+	for (int key = -5; key < 2005; key += 13) {
+		EXPECT_EQ(sl.contains(key), reference.count(key) == 1);
+		auto lower = sl.lower_bound(key);
+		auto referenceLower = reference.lower_bound(key);
+		if (referenceLower == reference.end()) {
+			EXPECT_EQ(lower, sl.end());
+		} else {
+			ASSERT_NE(lower, sl.end());
+			EXPECT_EQ(lower->key, referenceLower->first);
+		}
+		auto upper = sl.upper_bound(key);
+		auto referenceUpper = reference.upper_bound(key);
+		if (referenceUpper == reference.end()) {
+			EXPECT_EQ(upper, sl.end());
+		} else {
+			ASSERT_NE(upper, sl.end());
+			EXPECT_EQ(upper->key, referenceUpper->first);
+		}
+	}
+
+	std::vector<int> keys;
+	sl.scan(300, 1700, [&keys](const int& key, const int&) { keys.push_back(key); });
+	std::vector<int> expectedKeys;
+	for (auto it = reference.lower_bound(300); it != reference.lower_bound(1700); ++it) {
+		expectedKeys.push_back(it->first);
+	}
+	EXPECT_EQ(keys, expectedKeys);
+
+	keys.clear();
+	std::size_t visited = sl.scan(0, 2000, [&keys](const int& key, const int&) {
+		keys.push_back(key);
+		return keys.size() < 5;
+	});
+	EXPECT_EQ(visited, 5u);
+	auto fifth = reference.begin();
+	std::advance(fifth, 5);
+	std::vector<int> firstKeys;
+	for (auto it = reference.begin(); it != fifth; ++it) {
+		firstKeys.push_back(it->first);
+	}
+	EXPECT_EQ(keys, firstKeys);
+}
+
+} // namespace
+
+TEST(ShardedSkipListTest, HashShardsMatchStdMap) {
+	skiplist::ShardedSkipList<int, int> sl(8, 16);
+	EXPECT_EQ(sl.shardCount(), 8);
+	expectMatchesStdMap(sl);
+
+	// 哈希打散后每个分片都分到了数据
+	for (int size : sl.shardSizes()) {
+		EXPECT_GT(size, sl.size() / 16);
+	}
+}
+
+TEST(ShardedSkipListTest, RangeShardsMatchStdMap) {
+	skiplist::ShardedSkipList<int, int> sl(std::vector<int>{1500, 500, 1000, 500}, 16);
+	EXPECT_EQ(sl.shardCount(), 4); // 重复的分界点只保留一个
+	expectMatchesStdMap(sl);
+}
+
+TEST(ShardedSkipListTest, RangeShardsPartitionByKey) {
+	skiplist::ShardedSkipList<int, std::string> sl(std::vector<int>{100, 200, 300}, 16);
+	for (int i = 0; i < 400; i++) {
+		EXPECT_TRUE(sl.insert(i, std::to_string(i)));
+	}
+	EXPECT_EQ(sl.shardSizes(), (std::vector<int>{100, 100, 100, 100}));
+	EXPECT_EQ(*sl.search(250), "250");
+	EXPECT_EQ(sl.lower_bound(199)->key, 199);
+	EXPECT_EQ(sl.upper_bound(199)->key, 200);
+	EXPECT_EQ(sl.upper_bound(399), sl.end());
+
+	// 跨越分界点的扫描，提前结束后不再访问后面的分片
+	std::vector<int> keys;
+	std::size_t visited = sl.scan(195, 305, [&keys](const int& key, const std::string&) {
+		keys.push_back(key);
+		return key < 201;
+	});
+	EXPECT_EQ(visited, 7u);
+	EXPECT_EQ(keys, (std::vector<int>{195, 196, 197, 198, 199, 200, 201}));
+}
+
+TEST(ShardedSkipListTest, InsertBatchSplitsByShard) {
+	skiplist::ShardedSkipList<int, int> sl(4, 16);
+	std::vector<std::pair<int, int>> batch;
+	for (int i = 0; i < 1000; i++) {
+		batch.emplace_back(i, i);
+	}
+	batch.emplace_back(10, -1); // 重复的键保留第一次出现的值
+	EXPECT_EQ(sl.insertBatch(batch), 1000u);
+	EXPECT_EQ(sl.size(), 1000);
+	EXPECT_EQ(*sl.search(10), 10);
+}
+
+TEST(ShardedSkipListTest, ConcurrentWriters) {
+	constexpr int kThreads = 4;
+	constexpr int kPerThread = 2000;
+	skiplist::ShardedSkipList<int, int> sl(8, 16);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; t++) {
+		threads.emplace_back([&sl, t] {
+			for (int i = 0; i < kPerThread; i++) {
+				int key = i * kThreads + t;
+				sl.insert(key, key);
+				if (i % 4 == 0) {
+					sl.remove(key);
+				}
+				sl.contains(key + 1);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(sl.size(), kThreads * kPerThread * 3 / 4);
+	int previous = -1;
+	for (auto it = sl.begin(); it != sl.end(); ++it) {
+		EXPECT_GT(it->key, previous);
+		EXPECT_NE((it->key / kThreads) % 4, 0);
+		previous = it->key;
+	}
+}
@@ -1,7 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
 #include <random>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -26,28 +39,25 @@ TEST_F(SkipListTest, InsertAndSearch) {
 	sl->insert(10, "ten");
 	sl->insert(3, "three");
 
-	auto node = sl->search(5);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->key, 5);
-	EXPECT_EQ(node->value, "five");
+	auto value = sl->search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
 
-	node = sl->search(10);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->key, 10);
-	EXPECT_EQ(node->value, "ten");
+	value = sl->search(10);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "ten");
 
-	node = sl->search(3);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->key, 3);
-	EXPECT_EQ(node->value, "three");
+	value = sl->search(3);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "three");
 }
 
 TEST_F(SkipListTest, SearchNonExistent) {
 	// 测试搜索不存在的键
 	sl->insert(5, "five");
 
-	auto node = sl->search(10);
-	EXPECT_EQ(node, nullptr);
+	auto value = sl->search(10);
+	EXPECT_FALSE(value.has_value());
 }
 
 TEST_F(SkipListTest, Remove) {
@@ -58,17 +68,17 @@ TEST_F(SkipListTest, Remove) {
 
 	// 删除存在的键
 	sl->remove(5);
-	auto node = sl->search(5);
-	EXPECT_EQ(node, nullptr);
+	auto value = sl->search(5);
+	EXPECT_FALSE(value.has_value());
 
 	// 确保其他键仍然存在
-	node = sl->search(10);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->value, "ten");
+	value = sl->search(10);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "ten");
 
-	node = sl->search(3);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->value, "three");
+	value = sl->search(3);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "three");
 }
 
 TEST_F(SkipListTest, RemoveNonExistent) {
@@ -77,9 +87,9 @@ TEST_F(SkipListTest, RemoveNonExistent) {
 	sl->remove(10); // 这应该不会崩溃
 
 	// 确保原有的键仍然存在
-	auto node = sl->search(5);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->value, "five");
+	auto value = sl->search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
 }
 
 TEST_F(SkipListTest, DuplicateInsert) {
@@ -88,15 +98,15 @@ TEST_F(SkipListTest, DuplicateInsert) {
 	sl->insert(5, "five_duplicate");
 
 	// 应该只有一个节点，值应该是原来的
-	auto node = sl->search(5);
-	ASSERT_NE(node, nullptr);
-	EXPECT_EQ(node->value, "five");
+	auto value = sl->search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
 }
 
 TEST_F(SkipListTest, EmptySkipList) {
 	// 测试空跳表
-	auto node = sl->search(5);
-	EXPECT_EQ(node, nullptr);
+	auto value = sl->search(5);
+	EXPECT_FALSE(value.has_value());
 }
 
 TEST_F(SkipListTest, MultipleOperations) {
@@ -110,10 +120,9 @@ TEST_F(SkipListTest, MultipleOperations) {
 
 	// 验证所有键都能找到
 	for (int key : keys) {
-		auto node = sl->search(key);
-		ASSERT_NE(node, nullptr);
-		EXPECT_EQ(node->key, key);
-		EXPECT_EQ(node->value, "value_" + std::to_string(key));
+		auto value = sl->search(key);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, "value_" + std::to_string(key));
 	}
 
 	// 删除一些键
@@ -121,18 +130,639 @@ TEST_F(SkipListTest, MultipleOperations) {
 	sl->remove(7);
 
 	// 验证删除的键找不到
-	EXPECT_EQ(sl->search(3), nullptr);
-	EXPECT_EQ(sl->search(7), nullptr);
+	EXPECT_FALSE(sl->search(3).has_value());
+	EXPECT_FALSE(sl->search(7).has_value());
 
 	// 验证其他键仍然存在
 	std::vector<int> remaining_keys = {1, 5, 8, 2, 4, 6};
 	for (int key : remaining_keys) {
-		auto node = sl->search(key);
-		ASSERT_NE(node, nullptr);
-		EXPECT_EQ(node->key, key);
+		auto value = sl->search(key);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, "value_" + std::to_string(key));
 	}
 }
 
+TEST_F(SkipListTest, OperationStatus) {
+	// 测试各操作的返回值
+	EXPECT_TRUE(sl->insert(5, "five"));
+	EXPECT_FALSE(sl->insert(5, "five_duplicate"));
+
+	EXPECT_TRUE(sl->contains(5));
+	EXPECT_FALSE(sl->contains(6));
+
+	EXPECT_FALSE(sl->remove(6));
+	EXPECT_TRUE(sl->remove(5));
+	EXPECT_FALSE(sl->remove(5));
+	EXPECT_FALSE(sl->contains(5));
+}
+
+TEST_F(SkipListTest, SizeAndLevelHistogram) {
+	// 测试 O(1) 维护的元素个数与层分布
+	EXPECT_TRUE(sl->empty());
+	EXPECT_EQ(sl->size(), 0);
+
+	for (int i = 0; i < 1000; i++) {
+		sl->insert(i, "value");
+	}
+	sl->insert(10, "duplicate");
+	EXPECT_FALSE(sl->empty());
+	EXPECT_EQ(sl->size(), 1000);
+
+	auto histogram = sl->levelHistogram();
+	ASSERT_EQ(histogram.size(), 17u);
+	EXPECT_EQ(histogram[0], 1000);
+	for (size_t i = 1; i < histogram.size(); i++) {
+		EXPECT_LE(histogram[i], histogram[i - 1]);
+	}
+
+	for (int i = 0; i < 1000; i += 2) {
+		sl->remove(i);
+	}
+	sl->remove(0);
+	EXPECT_EQ(sl->size(), 500);
+	EXPECT_EQ(sl->levelHistogram()[0], 500);
+
+	for (int i = 1; i < 1000; i += 2) {
+		sl->remove(i);
+	}
+	EXPECT_TRUE(sl->empty());
+	for (int count : sl->levelHistogram()) {
+		EXPECT_EQ(count, 0);
+	}
+}
+
+TEST_F(SkipListTest, OrderedIteration) {
+	// 测试迭代器按键升序遍历
+	std::vector<int> keys = {7, 3, 9, 1, 5};
+	for (int key : keys) {
+		sl->insert(key, "value_" + std::to_string(key));
+	}
+
+	std::vector<int> visited;
+	for (const auto& node : *sl) {
+		visited.push_back(node.key);
+		EXPECT_EQ(node.value, "value_" + std::to_string(node.key));
+	}
+	EXPECT_EQ(visited, (std::vector<int>{1, 3, 5, 7, 9}));
+	EXPECT_EQ(std::distance(sl->begin(), sl->end()), 5);
+
+	skiplist::SkipList<int, std::string> emptyList(16);
+	EXPECT_EQ(emptyList.begin(), emptyList.end());
+}
+
+TEST_F(SkipListTest, LowerAndUpperBound) {
+	for (int key = 10; key <= 50; key += 10) {
+		sl->insert(key, std::to_string(key));
+	}
+
+	EXPECT_EQ(sl->lower_bound(30)->key, 30);
+	EXPECT_EQ(sl->upper_bound(30)->key, 40);
+	EXPECT_EQ(sl->lower_bound(25)->key, 30);
+	EXPECT_EQ(sl->upper_bound(25)->key, 30);
+	EXPECT_EQ(sl->lower_bound(0)->key, 10);
+	EXPECT_EQ(sl->lower_bound(51), sl->end());
+	EXPECT_EQ(sl->upper_bound(50), sl->end());
+}
+
+TEST_F(SkipListTest, RangeScan) {
+	for (int key = 0; key < 100; key++) {
+		sl->insert(key, std::to_string(key));
+	}
+
+	// [lo, hi) 半开区间
+	std::vector<int> visited;
+	size_t count = sl->scan(10, 20, [&visited](const int& key, const std::string& value) {
+		EXPECT_EQ(value, std::to_string(key));
+		visited.push_back(key);
+	});
+	EXPECT_EQ(count, 10u);
+	ASSERT_EQ(visited.size(), 10u);
+	EXPECT_EQ(visited.front(), 10);
+	EXPECT_EQ(visited.back(), 19);
+
+	// 回调返回 false 时提前结束
+	visited.clear();
+	sl->scan(50, 100, [&visited](const int& key, const std::string&) {
+		visited.push_back(key);
+		return visited.size() < 3;
+	});
+	EXPECT_EQ(visited, (std::vector<int>{50, 51, 52}));
+
+	// 空区间
+	EXPECT_EQ(sl->scan(200, 300, [](const int&, const std::string&) {}), 0u);
+	EXPECT_EQ(sl->scan(20, 10, [](const int&, const std::string&) {}), 0u);
+}
+
+TEST_F(SkipListTest, InsertBatch) {
+	sl->insert(5, "existing");
+
+	std::vector<std::pair<int, std::string>> batch = {
+		{9, "nine"}, {1, "one"}, {5, "five"}, {3, "three"}, {9, "nine_again"}, {7, "seven"}};
+	// 5 已存在，第二个 9 是批内重复
+	EXPECT_EQ(sl->insertBatch(batch), 4u);
+	EXPECT_EQ(sl->size(), 5);
+
+	EXPECT_EQ(*sl->search(5), "existing");
+	EXPECT_EQ(*sl->search(9), "nine");
+	EXPECT_EQ(*sl->search(1), "one");
+
+	std::vector<int> keys;
+	for (const auto& node : *sl) {
+		keys.push_back(node.key);
+	}
+	EXPECT_EQ(keys, (std::vector<int>{1, 3, 5, 7, 9}));
+
+	// 大批量随机键与逐个插入结果一致
+	std::vector<std::pair<int, std::string>> large;
+	std::mt19937 gen(42);
+	for (int i = 0; i < 5000; i++) {
+		int key = static_cast<int>(gen() % 20000);
+		large.emplace_back(key, std::to_string(key));
+	}
+	sl->insertBatch(large);
+	int previous = -1;
+	for (const auto& node : *sl) {
+		EXPECT_GT(node.key, previous);
+		previous = node.key;
+	}
+	for (const auto& entry : large) {
+		EXPECT_TRUE(sl->contains(entry.first));
+	}
+	EXPECT_EQ(static_cast<int>(std::distance(sl->begin(), sl->end())), sl->size());
+}
+
+TEST_F(SkipListTest, BulkLoadSorted) {
+	std::vector<std::pair<int, std::string>> sorted;
+	for (int i = 0; i < 1024; i++) {
+		sorted.emplace_back(i * 2, std::to_string(i * 2));
+	}
+	// 不满足严格递增的元素被跳过
+	sorted.insert(sorted.begin() + 10, {4, "out_of_order"});
+
+	EXPECT_EQ(sl->bulkLoad(sorted.begin(), sorted.end()), 1024u);
+	EXPECT_EQ(sl->size(), 1024);
+	EXPECT_EQ(*sl->search(4), "4");
+	EXPECT_EQ(*sl->search(2046), "2046");
+	EXPECT_FALSE(sl->contains(3));
+
+	// p = 0.5 时层高确定且完全均匀：第 i 层恰有 1024 / 2^i 个节点
+	auto histogram = sl->levelHistogram();
+	for (int i = 0; i <= 10; i++) {
+		EXPECT_EQ(histogram[i], 1024 >> i);
+	}
+
+	// 构建后的跳表可以继续正常读写
+	EXPECT_TRUE(sl->insert(1, "one"));
+	EXPECT_TRUE(sl->remove(2));
+	EXPECT_EQ(sl->size(), 1024);
+	std::vector<int> firstKeys;
+	sl->scan(0, 7, [&firstKeys](const int& key, const std::string&) { firstKeys.push_back(key); });
+	EXPECT_EQ(firstKeys, (std::vector<int>{0, 1, 4, 6}));
+
+	// 非空时退化为批量插入
+	std::vector<std::pair<int, std::string>> more = {{3, "three"}, {4, "dup"}};
+	EXPECT_EQ(sl->bulkLoad(more.begin(), more.end()), 1u);
+	EXPECT_EQ(*sl->search(4), "4");
+}
+
+// 用 finger 查找/插入的结果与普通接口一致，不论键向前、向后跳还是中间夹着 remove
+TEST_F(SkipListTest, FingerSearchAndInsert) {
+	skiplist::SkipList<int, std::string>::Finger finger;
+
+	// 递增插入：每次都从上一个键的路径继续
+	for (int i = 0; i < 2000; i += 2) {
+		EXPECT_TRUE(sl->insert(i, std::to_string(i), finger));
+	}
+	EXPECT_FALSE(sl->insert(100, "dup", finger));
+	EXPECT_EQ(sl->size(), 1000);
+
+	for (int i = 0; i < 2000; i++) {
+		auto value = sl->search(i, finger);
+		if (i % 2 == 0) {
+			ASSERT_TRUE(value.has_value());
+			EXPECT_EQ(*value, std::to_string(i));
+		} else {
+			EXPECT_FALSE(value.has_value());
+		}
+	}
+
+	// 随机跳跃（包括向后）与中途删除
+	std::mt19937 gen(3);
+	for (int round = 0; round < 5000; round++) {
+		int key = static_cast<int>(gen() % 4000) - 100;
+		switch (gen() % 4) {
+		case 0: {
+			bool existed = sl->contains(key);
+			EXPECT_EQ(sl->insert(key, std::to_string(key), finger), !existed);
+			break;
+		}
+		case 1:
+			sl->remove(key);
+			break;
+		default:
+			EXPECT_EQ(sl->search(key, finger), sl->search(key));
+			break;
+		}
+	}
+
+	int previous = -1000;
+	for (const auto& node : *sl) {
+		EXPECT_GT(node.key, previous);
+		EXPECT_EQ(node.value, std::to_string(node.key));
+		previous = node.key;
+	}
+	EXPECT_EQ(static_cast<int>(std::distance(sl->begin(), sl->end())), sl->size());
+
+	// 一个 finger 换到另一个跳表上使用时会自动重置
+	skiplist::SkipList<int, std::string> other(16);
+	EXPECT_TRUE(other.insert(1, "one", finger));
+	EXPECT_EQ(*other.search(1, finger), "one");
+	EXPECT_FALSE(sl->search(-1000, finger).has_value());
+}
+
+namespace {
+
+// 批量查找与逐个 search 的结果一致。分别取少量键（交错执行）和全部键（沿前驱路径依次查找）
+template <typename SkipListType, typename Key>
+void expectMultiGetMatchesSearch(const SkipListType& sl, const std::vector<Key>& keys) {
+	for (std::size_t count : {std::min<std::size_t>(keys.size(), 20), keys.size()}) {
+		std::vector<Key> batch(keys.begin(), keys.begin() + count);
+		auto values = sl.multiGet(batch);
+		ASSERT_EQ(values.size(), batch.size());
+		for (std::size_t i = 0; i < batch.size(); i++) {
+			EXPECT_EQ(values[i], sl.search(batch[i])) << batch[i];
+		}
+	}
+}
+
+} // namespace
+
+// 包括重复的键、不存在的键和空批
+TEST_F(SkipListTest, MultiGet) {
+	EXPECT_TRUE(sl->multiGet({}).empty());
+	EXPECT_EQ(sl->multiGet({1, 2}), (std::vector<std::optional<std::string>>(2)));
+
+	for (int i = 0; i < 3000; i += 3) {
+		sl->insert(i, std::to_string(i));
+	}
+	std::vector<int> keys;
+	std::mt19937 gen(5);
+	for (int i = 0; i < 500; i++) {
+		keys.push_back(static_cast<int>(gen() % 3100) - 50);
+	}
+	keys.push_back(keys.front());
+	keys.push_back(2997);
+	keys.push_back(std::numeric_limits<int>::max());
+
+	expectMultiGetMatchesSearch(*sl, keys);
+
+	// 花括号列表和 std::array 都可以直接传入
+	EXPECT_EQ(sl->multiGet({3, 4, 3}),
+			  (std::vector<std::optional<std::string>>{"3", std::nullopt, "3"}));
+	std::array<int, 2> pair = {2997, 0};
+	EXPECT_EQ(sl->multiGet(pair), (std::vector<std::optional<std::string>>{"2997", "0"}));
+}
+
+// 批量写入与依次调用 insert_or_assign 的结果一致，返回值按原来的顺序对应
+TEST_F(SkipListTest, MultiPut) {
+	EXPECT_TRUE(sl->multiPut(std::vector<std::pair<int, std::string>>()).empty());
+
+	std::map<int, std::string> reference;
+	std::mt19937 gen(9);
+	for (int round = 0; round < 40; round++) {
+		// 大批在表中密集，沿前驱路径依次写入；小批稀疏，每个键从 header 下降
+		int batchSize = round % 2 == 0 ? 100 : 5;
+		std::vector<std::pair<int, std::string>> entries;
+		for (int i = 0; i < batchSize; i++) {
+			int key = static_cast<int>(gen() % 1000);
+			entries.emplace_back(key, std::to_string(round * 1000 + i));
+		}
+
+		std::vector<bool> inserted = sl->multiPut(entries);
+		ASSERT_EQ(inserted.size(), entries.size());
+		for (std::size_t i = 0; i < entries.size(); i++) {
+			bool expected = reference.find(entries[i].first) == reference.end();
+			reference[entries[i].first] = entries[i].second;
+			EXPECT_EQ(inserted[i], expected) << entries[i].first;
+		}
+	}
+
+	ASSERT_EQ(sl->size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (auto it = sl->begin(); it != sl->end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->first);
+		EXPECT_EQ(it->value, expected->second);
+	}
+
+	// 同一个键多次出现：第一次插入，之后依次覆盖
+	EXPECT_EQ(sl->multiPut({{5000, "a"}, {-1, "b"}, {5000, "c"}}),
+			  (std::vector<bool>{true, true, false}));
+	EXPECT_EQ(*sl->search(5000), "c");
+}
+
+// 可修改的 Span 把键值移动进跳表，只能移动的值类型也可以批量写入
+TEST(SkipListMultiPutTest, MovesFromMutableSpan) {
+	skiplist::SkipList<std::string, std::unique_ptr<int>> sl(16);
+	std::vector<std::pair<std::string, std::unique_ptr<int>>> entries;
+	for (int i = 0; i < 50; i++) {
+		entries.emplace_back("key" + std::to_string(i % 40), std::make_unique<int>(i));
+	}
+
+	std::vector<bool> inserted =
+		sl.multiPut(skiplist::Span<std::pair<std::string, std::unique_ptr<int>>>(entries));
+	for (int i = 0; i < 50; i++) {
+		EXPECT_EQ(inserted[i], i < 40) << i;
+		EXPECT_EQ(entries[i].second, nullptr) << i; // 值都被移走了
+	}
+	EXPECT_EQ(sl.size(), 40);
+
+	// 覆盖时同样移动值，键相同的后一项生效
+	int visited = 0;
+	sl.forEach([&visited](const std::string& key, const std::unique_ptr<int>& value) {
+		int index = std::stoi(key.substr(3));
+		EXPECT_EQ(*value, index < 10 ? index + 40 : index) << key;
+		visited++;
+	});
+	EXPECT_EQ(visited, 40);
+}
+
+// 没有后继键缓存的键类型走通用的下降路径
+TEST(SkipListMultiGetTest, StringKeysAndCustomOrder) {
+	skiplist::SkipList<std::string, int> strings(16);
+	skiplist::SkipList<int, int, std::greater<int>> descending(16);
+	for (int i = 0; i < 1000; i += 2) {
+		strings.insert("key" + std::to_string(i), i);
+		descending.insert(i, i);
+	}
+
+	std::vector<std::string> stringKeys;
+	std::vector<int> intKeys;
+	for (int i = -3; i < 1003; i += 7) {
+		stringKeys.push_back("key" + std::to_string(i));
+		intKeys.push_back(i);
+	}
+	expectMultiGetMatchesSearch(strings, stringKeys);
+	expectMultiGetMatchesSearch(descending, intKeys);
+
+	std::vector<bool> inserted = descending.multiPut({{1, 10}, {2000, 20}, {2, 30}});
+	EXPECT_EQ(inserted, (std::vector<bool>{true, true, false}));
+	EXPECT_EQ(descending.begin()->key, 2000);
+	EXPECT_EQ(*descending.search(2), 30);
+}
+
+// 编译期层数上限：运行期的 maxLvl 不能超过它，默认构造使用 MaxLevel
+TEST(SkipListMaxLevelTest, CompileTimeBound) {
+	skiplist::SkipList<int, int, std::less<int>, skiplist::NewDeleteAllocator, 4> small(16);
+	for (int i = 0; i < 1000; i++) {
+		EXPECT_TRUE(small.insert(i, i));
+	}
+	EXPECT_EQ(small.levelHistogram().size(), 5u);
+	EXPECT_EQ(small.levelHistogram()[0], 1000);
+	for (int i = 0; i < 1000; i += 3) {
+		EXPECT_TRUE(small.remove(i));
+	}
+	EXPECT_EQ(*small.search(998), 998);
+	EXPECT_FALSE(small.contains(999));
+
+	skiplist::SkipList<int, int> defaulted;
+	EXPECT_EQ(defaulted.levelHistogram().size(), 33u);
+	EXPECT_TRUE(defaulted.insert(1, 1));
+	EXPECT_EQ(defaulted.size(), 1);
+}
+
+namespace {
+
+// 统计拷贝与移动次数的值类型
+struct CopyCounter {
+	static int copies;
+	static int moves;
+
+	std::string payload;
+
+	CopyCounter() = default;
+	explicit CopyCounter(std::string s) : payload(std::move(s)) {}
+	CopyCounter(const CopyCounter& other) : payload(other.payload) {
+		copies++;
+	}
+	CopyCounter(CopyCounter&& other) noexcept : payload(std::move(other.payload)) {
+		moves++;
+	}
+	CopyCounter& operator=(const CopyCounter& other) {
+		payload = other.payload;
+		copies++;
+		return *this;
+	}
+	CopyCounter& operator=(CopyCounter&& other) noexcept {
+		payload = std::move(other.payload);
+		moves++;
+		return *this;
+	}
+};
+
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+} // namespace
+
+TEST(SkipListEmplaceTest, InsertWithoutCopies) {
+	skiplist::SkipList<int, CopyCounter> sl(16);
+	CopyCounter::copies = 0;
+	CopyCounter::moves = 0;
+
+	// 右值插入：值只被移动一次，直接进入节点
+	EXPECT_TRUE(sl.insert(1, CopyCounter("one")));
+	EXPECT_EQ(CopyCounter::copies, 0);
+	EXPECT_EQ(CopyCounter::moves, 1);
+
+	// 原地构造：既不拷贝也不移动
+	EXPECT_TRUE(sl.try_emplace(2, "two"));
+	EXPECT_TRUE(sl.emplace(3, "three"));
+	EXPECT_EQ(CopyCounter::copies, 0);
+	EXPECT_EQ(CopyCounter::moves, 1);
+
+	// 左值插入只拷贝一次
+	CopyCounter four("four");
+	EXPECT_TRUE(sl.insert(4, four));
+	EXPECT_EQ(CopyCounter::copies, 1);
+
+	// 键已存在时 try_emplace 不使用参数
+	std::string unused = "unused";
+	EXPECT_FALSE(sl.try_emplace(2, std::move(unused)));
+	EXPECT_EQ(unused, "unused");
+	EXPECT_EQ(sl.search(2)->payload, "two");
+	EXPECT_EQ(sl.size(), 4);
+}
+
+TEST(SkipListEmplaceTest, InsertOrAssign) {
+	skiplist::SkipList<std::string, std::string> sl(16);
+	EXPECT_TRUE(sl.insert_or_assign("apple", "red"));
+	EXPECT_FALSE(sl.insert_or_assign("apple", "green"));
+	EXPECT_EQ(*sl.search("apple"), "green");
+	EXPECT_EQ(sl.size(), 1);
+
+	std::string key = "banana";
+	std::string value = "yellow";
+	EXPECT_TRUE(sl.insert_or_assign(std::move(key), std::move(value)));
+	EXPECT_EQ(*sl.search("banana"), "yellow");
+
+	// emplace 用可以构造出键的参数
+	EXPECT_TRUE(sl.emplace("cherry", 3, 'r'));
+	EXPECT_EQ(*sl.search("cherry"), "rrr");
+	EXPECT_FALSE(sl.emplace(std::string("cherry"), "dark"));
+}
+
+// 用 std::string_view / 字符串字面量查找 std::string 键，不构造临时字符串
+TEST(SkipListEmplaceTest, HeterogeneousLookup) {
+	skiplist::SkipList<std::string, int, std::less<>> sl(16);
+	for (int i = 0; i < 100; i++) {
+		sl.insert("key_" + std::to_string(i), i);
+	}
+
+	std::string_view view = "key_42";
+	auto value = sl.search(view);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, 42);
+	EXPECT_TRUE(sl.contains(std::string_view("key_7")));
+	EXPECT_FALSE(sl.contains(std::string_view("key_100")));
+	EXPECT_EQ(*sl.search("key_99"), 99);
+	EXPECT_FALSE(sl.search("missing").has_value());
+}
+
+// 逆序比较器：遍历、范围查询和 finger 都按比较器的顺序
+TEST(SkipListCompareTest, ReverseOrder) {
+	skiplist::SkipList<int, int, std::greater<int>> sl(16);
+	for (int i = 0; i < 100; i++) {
+		EXPECT_TRUE(sl.insert(i, i * 10));
+	}
+	EXPECT_FALSE(sl.insert(50, 0));
+	EXPECT_EQ(*sl.search(42), 420);
+
+	std::vector<int> keys;
+	for (const auto& node : sl) {
+		keys.push_back(node.key);
+	}
+	ASSERT_EQ(keys.size(), 100u);
+	EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end(), std::greater<int>()));
+
+	EXPECT_EQ(sl.lower_bound(50)->key, 50);
+	EXPECT_EQ(sl.upper_bound(50)->key, 49);
+
+	// [lo, hi) 也按比较器的顺序解释
+	std::vector<int> range;
+	sl.scan(20, 15, [&range](const int& key, const int&) { range.push_back(key); });
+	EXPECT_EQ(range, (std::vector<int>{20, 19, 18, 17, 16}));
+
+	skiplist::SkipList<int, int, std::greater<int>>::Finger finger;
+	EXPECT_TRUE(sl.insert(200, 0, finger));
+	EXPECT_EQ(*sl.search(3, finger), 30);
+	EXPECT_EQ(sl.begin()->key, 200);
+}
+
+namespace {
+
+// 忽略大小写的比较器，带状态以验证比较器对象被保存并使用
+struct CaseInsensitiveLess {
+	int* calls;
+
+	bool operator()(const std::string& a, const std::string& b) const {
+		++*calls;
+		return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+											[](char x, char y) {
+												return std::tolower(static_cast<unsigned char>(x)) <
+													   std::tolower(static_cast<unsigned char>(y));
+											});
+	}
+};
+
+} // namespace
+
+TEST(SkipListCompareTest, StatefulComparator) {
+	int calls = 0;
+	skiplist::SkipList<std::string, int, CaseInsensitiveLess> sl(
+		16, 0.5f, skiplist::NewDeleteAllocator(), CaseInsensitiveLess{&calls});
+
+	EXPECT_TRUE(sl.insert("Apple", 1));
+	EXPECT_FALSE(sl.insert("APPLE", 2)); // 与 Apple 等价
+	EXPECT_TRUE(sl.insert("banana", 3));
+	EXPECT_EQ(*sl.search("aPPle"), 1);
+	EXPECT_TRUE(sl.contains("BANANA"));
+	EXPECT_GT(calls, 0);
+	EXPECT_EQ(sl.key_comp().calls, &calls);
+}
+
+// 带前缀的字符串键与 std::map 的结果一致，包括共享长前缀、含 '\0' 和高位字节的键
+TEST(SkipListCompareTest, StringPrefixMatchesStdMap) {
+	skiplist::SkipList<std::string, int, std::less<>> sl(16);
+	std::map<std::string, int> reference;
+
+	std::mt19937 gen(11);
+	const std::string alphabet("ab\0\x7f\x80\xff", 6);
+	for (int i = 0; i < 5000; i++) {
+		// 一半的键共享 8 字节以上的公共前缀，只能靠完整比较区分
+		std::string key = (gen() % 2 == 0) ? "common_prefix_" : "";
+		int length = static_cast<int>(gen() % 12);
+		for (int j = 0; j < length; j++) {
+			key.push_back(alphabet[gen() % alphabet.size()]);
+		}
+		bool inserted = reference.emplace(key, i).second;
+		EXPECT_EQ(sl.insert(key, i), inserted);
+	}
+
+	ASSERT_EQ(sl.size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (const auto& node : sl) {
+		EXPECT_EQ(node.key, expected->first);
+		++expected;
+	}
+
+	for (const auto& entry : reference) {
+		std::string_view view = entry.first;
+		auto value = sl.search(view);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, entry.second);
+	}
+	EXPECT_FALSE(sl.contains(std::string("ab\0", 3) + "missing"));
+}
+
+// arena 分配器
+TEST(ArenaAllocatorTest, ReusesFreedBlocksPerLevel) {
+	skiplist::ArenaAllocator arena;
+	void* a = arena.allocate(40, 0);
+	void* b = arena.allocate(40, 0);
+	void* c = arena.allocate(72, 4);
+	EXPECT_NE(a, b);
+	EXPECT_NE(a, c);
+
+	// 释放后同一高度的下一次分配复用该块
+	arena.deallocate(a, 40, 0);
+	EXPECT_EQ(arena.allocate(40, 0), a);
+
+	EXPECT_GT(arena.bytesReserved(), 0u);
+}
+
+TEST(ArenaAllocatorTest, SkipListWithArena) {
+	skiplist::SkipList<int, std::string, std::less<int>, skiplist::ArenaAllocator> arenaList(16);
+
+	for (int i = 0; i < 5000; i++) {
+		arenaList.insert(i, "value_" + std::to_string(i));
+	}
+	for (int i = 0; i < 5000; i += 2) {
+		arenaList.remove(i);
+	}
+	// 删除后释放的块被重新插入复用
+	for (int i = 0; i < 5000; i += 2) {
+		arenaList.insert(i, "again_" + std::to_string(i));
+	}
+
+	EXPECT_EQ(arenaList.size(), 5000);
+	auto value = arenaList.search(10);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "again_10");
+	value = arenaList.search(11);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "value_11");
+}
+
 // 并发测试相关
 class ConcurrentSkipListTest : public ::testing::Test {
 protected:
@@ -177,9 +807,8 @@ TEST_F(ConcurrentSkipListTest, ConcurrentInsert) {
 	// 随机检查一些键
 	for (int i = 0; i < 10; i++) {
 		int random_key = rand() % (num_threads * inserts_per_thread);
-		auto node = sl->search(random_key);
-		ASSERT_NE(node, nullptr);
-		EXPECT_EQ(node->key, random_key);
+		auto value = sl->search(random_key);
+		ASSERT_TRUE(value.has_value());
 	}
 }
 
@@ -201,8 +830,8 @@ TEST_F(ConcurrentSkipListTest, ConcurrentSearch) {
 		threads.emplace_back([this, num_keys, searches_per_thread, &found_count]() {
 			for (int j = 0; j < searches_per_thread; j++) {
 				int key = rand() % num_keys;
-				auto node = sl->search(key);
-				if (node != nullptr && node->key == key) {
+				auto value = sl->search(key);
+				if (value.has_value()) {
 					found_count.fetch_add(1);
 				}
 			}
@@ -294,8 +923,8 @@ TEST_F(ConcurrentSkipListTest, ConcurrentRemove) {
 
 	// 验证删除的键确实不存在了
 	for (int i = 0; i < num_threads * removes_per_thread; i++) {
-		auto node = sl->search(i);
-		EXPECT_EQ(node, nullptr);
+		auto value = sl->search(i);
+		EXPECT_FALSE(value.has_value());
 	}
 }
 
@@ -341,6 +970,44 @@ TEST_F(ConcurrentSkipListTest, StressTest) {
 	EXPECT_GE(sl->size(), 0); // 大小应该非负
 }
 
+// 扫描与并发写入：扫描持有读锁，看到的始终是有序且一致的快照
+TEST_F(ConcurrentSkipListTest, ScanDuringWrites) {
+	for (int i = 0; i < 1000; i += 2) {
+		sl->insert(i, "even");
+	}
+
+	std::atomic<bool> stop{false};
+	std::thread writer([this, &stop]() {
+		int round = 0;
+		while (!stop.load()) {
+			for (int i = 1; i < 1000; i += 2) {
+				if (round % 2 == 0) {
+					sl->insert(i, "odd");
+				} else {
+					sl->remove(i);
+				}
+			}
+			round++;
+		}
+	});
+
+	for (int round = 0; round < 50; round++) {
+		int previous = -1;
+		int evens = 0;
+		sl->scan(0, 1000, [&previous, &evens](const int& key, const std::string&) {
+			EXPECT_GT(key, previous);
+			previous = key;
+			if (key % 2 == 0) {
+				evens++;
+			}
+		});
+		EXPECT_EQ(evens, 500);
+	}
+
+	stop.store(true);
+	writer.join();
+}
+
 // 数据一致性测试
 TEST_F(ConcurrentSkipListTest, DataConsistency) {
 	// 插入一些初始数据
@@ -387,3 +1054,94 @@ TEST_F(ConcurrentSkipListTest, DataConsistency) {
 	// 2. 检查display()方法是否正常工作（不应该崩溃）
 	EXPECT_NO_THROW(sl->display());
 }
+
+// 快照：保存后加载得到相同的内容，损坏的文件不会改动跳表
+TEST(SkipListSnapshotTest, SaveAndLoadRoundTrip) {
+	std::string path = ::testing::TempDir() + "skiplist_snapshot_roundtrip.bin";
+	skiplist::SkipList<std::string, int> original(16);
+	for (int i = 0; i < 5000; i++) {
+		original.insert("key_" + std::to_string(i), i);
+	}
+	original.insert(std::string("with\0nul", 8), -1);
+	original.insert("", -2);
+	ASSERT_TRUE(original.saveTo(path));
+
+	skiplist::SkipList<std::string, int> loaded(16);
+	ASSERT_TRUE(loaded.loadFrom(path));
+	EXPECT_EQ(loaded.size(), original.size());
+	auto expected = original.begin();
+	for (auto it = loaded.begin(); it != loaded.end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->key);
+		EXPECT_EQ(it->value, expected->value);
+	}
+	EXPECT_EQ(*loaded.search(std::string("with\0nul", 8)), -1);
+	EXPECT_EQ(*loaded.search(""), -2);
+
+	// 加载到非空跳表时合并，已存在的键保留原值
+	skiplist::SkipList<std::string, int> merged(16);
+	merged.insert("key_1", 100);
+	merged.insert("zzz", 7);
+	ASSERT_TRUE(merged.loadFrom(path));
+	EXPECT_EQ(merged.size(), original.size() + 1);
+	EXPECT_EQ(*merged.search("key_1"), 100);
+	std::remove(path.c_str());
+}
+
+TEST(SkipListSnapshotTest, RejectsMissingAndCorruptFiles) {
+	std::string path = ::testing::TempDir() + "skiplist_snapshot_corrupt.bin";
+	skiplist::SkipList<int, std::string> sl(16);
+	EXPECT_FALSE(sl.loadFrom(path + ".missing"));
+
+	skiplist::SkipList<int, std::string> original(16);
+	for (int i = 0; i < 100; i++) {
+		original.insert(i, std::to_string(i));
+	}
+	ASSERT_TRUE(original.saveTo(path));
+
+	std::string contents;
+	ASSERT_TRUE(skiplist::detail::readFile(path, contents));
+	auto rewrite = [&path](const std::string& data) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), static_cast<std::streamsize>(data.size()));
+	};
+
+	rewrite(contents.substr(0, contents.size() - 1)); // 截断
+	EXPECT_FALSE(sl.loadFrom(path));
+	rewrite(contents + "x"); // 末尾多余字节
+	EXPECT_FALSE(sl.loadFrom(path));
+	std::string badMagic = contents;
+	badMagic[0] = 'X';
+	rewrite(badMagic);
+	EXPECT_FALSE(sl.loadFrom(path));
+	EXPECT_TRUE(sl.empty());
+
+	rewrite(contents);
+	EXPECT_TRUE(sl.loadFrom(path));
+	EXPECT_EQ(sl.size(), 100);
+	EXPECT_EQ(*sl.search(42), "42");
+	std::remove(path.c_str());
+}
+
+// 快照比写入和读取的分块大得多，且有一个值比整块还大：跨块的条目都能正确解码
+TEST(SkipListSnapshotTest, StreamsAcrossChunks) {
+	std::string path = ::testing::TempDir() + "skiplist_snapshot_chunks.bin";
+	skiplist::SkipList<int, std::string> original(16);
+	for (int i = 0; i < 20000; i++) {
+		original.insert(i, "value_" + std::to_string(i));
+	}
+	original.insert_or_assign(10000, std::string(300 * 1024, 'x'));
+	ASSERT_TRUE(original.saveTo(path));
+
+	skiplist::SkipList<int, std::string> restored(16);
+	ASSERT_TRUE(restored.loadFrom(path));
+	EXPECT_EQ(restored.size(), 20000);
+	EXPECT_EQ(restored.search(10000)->size(), 300u * 1024);
+	EXPECT_EQ(*restored.search(19999), "value_19999");
+
+	// 在大值中间截断
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+	skiplist::SkipList<int, std::string> truncated(16);
+	EXPECT_FALSE(truncated.loadFrom(path));
+	EXPECT_TRUE(truncated.empty());
+	std::remove(path.c_str());
+}
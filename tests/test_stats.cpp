@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "skiplist.hpp"
+#include "stats.hpp"
+
+static_assert(skiplist::detail::kStatsEnabled, "skiplist_stats_tests 需要定义 SKIPLIST_ENABLE_STATS");
+
+namespace {
+
+// 节点按 levelHistogram 推算出的当前占用字节数（含 header）
+std::uint64_t expectedLiveBytes(const skiplist::SkipListStats& stats) {
+	using NodeType = skiplist::Node<int, int>;
+	std::uint64_t bytes = NodeType::allocationSize(32);
+	const std::vector<int>& histogram = stats.levelHistogram;
+	for (std::size_t level = 0; level < histogram.size(); level++) {
+		int above = level + 1 < histogram.size() ? histogram[level + 1] : 0;
+		bytes += static_cast<std::uint64_t>(histogram[level] - above) *
+				 NodeType::allocationSize(static_cast<int>(level));
+	}
+	return bytes;
+}
+
+// 平均每层前进的节点数应接近 1/p - 1 到 1/p 之间（p = 1/2），只检查较低、样本充足的层
+template <typename K, typename MakeKey>
+void expectHopsPerLevel(MakeKey makeKey) {
+	skiplist::SkipList<K, int> sl(20);
+	for (int i = 0; i < 1 << 14; i++) {
+		sl.insert(makeKey(i), i);
+	}
+	for (int i = 0; i < 4000; i++) {
+		sl.search(makeKey(i * 7 % (1 << 14)));
+	}
+
+	skiplist::SkipListStats stats = sl.stats();
+	EXPECT_GE(stats.descents, 4000u + (1u << 14));
+	ASSERT_GE(stats.averageHopsPerLevel.size(), 8u);
+	for (int level = 0; level < 8; level++) {
+		EXPECT_GT(stats.averageHopsPerLevel[level], 0.3) << "level " << level;
+		EXPECT_LT(stats.averageHopsPerLevel[level], 2.0) << "level " << level;
+	}
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketError) {
+	skiplist::LatencyHistogram histogram;
+	EXPECT_EQ(histogram.percentile(0.5), 0);
+
+	// 16 ns 以下精确记录
+	for (std::uint64_t ns = 0; ns < 16; ns++) {
+		EXPECT_EQ(skiplist::LatencyHistogram::valueOf(skiplist::LatencyHistogram::bucketOf(ns)),
+				  static_cast<double>(ns));
+	}
+	// 更大的值落在代表值附近（相对误差不超过 1/16）
+	for (std::uint64_t ns : {16ULL, 17ULL, 100ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+		double value =
+			skiplist::LatencyHistogram::valueOf(skiplist::LatencyHistogram::bucketOf(ns));
+		EXPECT_NEAR(value, static_cast<double>(ns), static_cast<double>(ns) / 16.0) << ns;
+	}
+	// 超出上限的样本落在最后一个桶
+	EXPECT_EQ(skiplist::LatencyHistogram::bucketOf(~0ULL),
+			  skiplist::LatencyHistogram::kBuckets - 1);
+
+	for (std::uint64_t ns = 1; ns <= 1000; ns++) {
+		histogram.record(ns * 100);
+	}
+	EXPECT_EQ(histogram.count(), 1000u);
+	EXPECT_NEAR(histogram.percentile(0.5), 50000, 50000 / 16.0);
+	EXPECT_NEAR(histogram.percentile(0.99), 99000, 99000 / 16.0);
+	EXPECT_NEAR(histogram.percentile(1.0), 100000, 100000 / 16.0);
+
+	skiplist::LatencyHistogram other;
+	other.record(5);
+	histogram.merge(other);
+	EXPECT_EQ(histogram.count(), 1001u);
+	EXPECT_EQ(histogram.percentile(0.0), 5);
+}
+
+TEST(SkipListStatsTest, CountsOperationsAndBytes) {
+	skiplist::SkipList<int, int> sl(16);
+	for (int i = 0; i < 100; i++) {
+		sl.insert(i, i);
+	}
+	sl.insert_or_assign(5, 50);
+	sl.insertBatch({{200, 1}, {201, 2}});
+	for (int i = 0; i < 60; i++) {
+		sl.search(i * 2);
+	}
+	sl.contains(7);
+	for (int i = 0; i < 10; i++) {
+		sl.remove(i);
+	}
+	sl.scan(20, 40, [](const int&, const int&) {});
+	sl.forEach([](const int&, const int&) {});
+
+	skiplist::SkipListStats stats = sl.stats();
+	EXPECT_TRUE(stats.enabled);
+	EXPECT_EQ(stats.insert.count, 102u);
+	EXPECT_EQ(stats.search.count, 61u);
+	EXPECT_EQ(stats.remove.count, 10u);
+	EXPECT_EQ(stats.scan.count, 2u);
+	EXPECT_EQ(stats.search.latency.count(), stats.search.count);
+	EXPECT_GT(stats.search.latency.percentile(0.5), 0);
+
+	// 每次加锁都被记录，单线程下从不需要等待
+	EXPECT_EQ(stats.exclusiveLock.acquisitions, 112u);
+	EXPECT_EQ(stats.sharedLock.acquisitions, 63u);
+	EXPECT_EQ(stats.exclusiveLock.contended + stats.sharedLock.contended, 0u);
+
+	EXPECT_EQ(stats.levelHistogram, sl.levelHistogram());
+	EXPECT_EQ(stats.levelHistogram[0], 92);
+	EXPECT_GT(stats.bytesFreed, 0u);
+	EXPECT_EQ(stats.bytesAllocated - stats.bytesFreed, expectedLiveBytes(stats));
+}
+
+// bulkLoad 与 insertBatch 一样记一次 Insert 和一次写锁，跳表非空时也只加一次锁
+TEST(SkipListStatsTest, BulkLoadCountsAsOneInsert) {
+	skiplist::SkipList<int, int> sl(16);
+	std::vector<std::pair<int, int>> sorted;
+	for (int i = 0; i < 100; i++) {
+		sorted.emplace_back(i * 2, i);
+	}
+	EXPECT_EQ(sl.bulkLoad(sorted.begin(), sorted.end()), 100u);
+
+	std::vector<std::pair<int, int>> more = {{7, 0}, {3, 0}, {4, 0}};
+	EXPECT_EQ(sl.bulkLoad(more.begin(), more.end()), 2u);
+	EXPECT_EQ(sl.size(), 102);
+
+	skiplist::SkipListStats stats = sl.stats();
+	EXPECT_EQ(stats.insert.count, 2u);
+	EXPECT_EQ(stats.exclusiveLock.acquisitions, 2u);
+	EXPECT_EQ(stats.bytesAllocated - stats.bytesFreed, expectedLiveBytes(stats));
+}
+
+TEST(SkipListStatsTest, AverageHopsPerLevel) {
+	expectHopsPerLevel<int>([](int i) { return i; });
+	expectHopsPerLevel<std::string>([](int i) {
+		std::string key = std::to_string(i);
+		return std::string(6 - key.size(), '0') + key;
+	});
+}
+
+// 扫描持有读锁期间，写线程必须等待，等待被记为一次竞争
+TEST(SkipListStatsTest, RecordsLockWaits) {
+	skiplist::SkipList<int, int> sl(16);
+	for (int i = 0; i < 10; i++) {
+		sl.insert(i, i);
+	}
+
+	std::atomic<bool> scanning{false};
+	std::thread writer;
+	sl.scan(0, 1, [&](const int&, const int&) {
+		scanning = true;
+		writer = std::thread([&sl] { sl.insert(100, 100); });
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	});
+	writer.join();
+	ASSERT_TRUE(scanning);
+
+	skiplist::SkipListStats stats = sl.stats();
+	EXPECT_EQ(stats.exclusiveLock.contended, 1u);
+	EXPECT_GE(stats.exclusiveLock.waitNanos, 10'000'000u);
+	// 插入的延迟包括等锁的时间
+	EXPECT_GE(stats.insert.latency.percentile(1.0), 10'000'000.0);
+}
+
+// 各线程写不同的分片，汇总后的计数是精确的
+TEST(SkipListStatsTest, ShardedCountersFromManyThreads) {
+	constexpr int kThreads = 6;
+	constexpr int kPerThread = 2000;
+	skiplist::SkipList<int, int> sl(16);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; t++) {
+		threads.emplace_back([&sl, t] {
+			for (int i = 0; i < kPerThread; i++) {
+				sl.insert(t * kPerThread + i, i);
+				sl.search(i);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	skiplist::SkipListStats stats = sl.stats();
+	EXPECT_EQ(stats.insert.count, static_cast<std::uint64_t>(kThreads * kPerThread));
+	EXPECT_EQ(stats.search.count, static_cast<std::uint64_t>(kThreads * kPerThread));
+	EXPECT_EQ(stats.insert.latency.count(), stats.insert.count);
+	EXPECT_EQ(stats.exclusiveLock.acquisitions, stats.insert.count);
+	EXPECT_EQ(stats.sharedLock.acquisitions, stats.search.count);
+	EXPECT_EQ(stats.bytesFreed, 0u);
+}
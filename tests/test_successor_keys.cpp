@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "skiplist.hpp"
+#include "successor_keys.hpp"
+
+namespace {
+
+// 各个比较内核在非递减序列上的结果必须与逐个比较一致
+template <typename Code>
+void expectKernelsAgree() {
+	std::mt19937_64 gen(7);
+	for (int round = 0; round < 2000; round++) {
+		int count = static_cast<int>(gen() % 34);
+		std::vector<Code> codes(count);
+		for (auto& code : codes) {
+			code = static_cast<Code>(gen() % 64) - 32;
+		}
+		std::sort(codes.begin(), codes.end());
+		// 末尾若干项模拟没有后继的层
+		int none = count == 0 ? 0 : static_cast<int>(gen() % (count + 1));
+		std::fill(codes.end() - none, codes.end(), std::numeric_limits<Code>::max());
+
+		Code key = static_cast<Code>(gen() % 70) - 35;
+		if (round % 50 == 0) {
+			key = std::numeric_limits<Code>::max();
+		}
+		int expected = static_cast<int>(std::lower_bound(codes.begin(), codes.end(), key) -
+										codes.begin());
+
+		EXPECT_EQ(skiplist::detail::countLessScalar(codes.data(), count, key), expected);
+		EXPECT_EQ(skiplist::detail::countLess(codes.data(), count, key), expected);
+#ifdef SKIPLIST_X86_DISPATCH
+		if (skiplist::detail::cpuFeatures().sse42) {
+			EXPECT_EQ(skiplist::detail::countLessSse(codes.data(), count, key), expected);
+		}
+		if (skiplist::detail::cpuFeatures().avx2) {
+			EXPECT_EQ(skiplist::detail::countLessAvx2(codes.data(), count, key), expected);
+		}
+#endif
+	}
+}
+
+// 随机插入/删除/查找与 std::map 对照，键包含类型的最小值和最大值
+template <typename K>
+void expectMatchesStdMap() {
+	skiplist::SkipList<K, int> sl(16);
+	std::map<K, int> reference;
+	std::mt19937_64 gen(11);
+	std::vector<K> keys = {std::numeric_limits<K>::min(), std::numeric_limits<K>::max(), 0};
+	for (int i = 0; i < 500; i++) {
+		keys.push_back(static_cast<K>(gen()));
+	}
+
+	for (int round = 0; round < 20000; round++) {
+		K key = keys[gen() % keys.size()];
+		switch (gen() % 3) {
+		case 0:
+			EXPECT_EQ(sl.insert(key, round), reference.emplace(key, round).second);
+			break;
+		case 1:
+			EXPECT_EQ(sl.remove(key), reference.erase(key) == 1);
+			break;
+		default:
+			EXPECT_EQ(sl.contains(key), reference.count(key) == 1);
+			break;
+		}
+	}
+
+	ASSERT_EQ(sl.size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (auto it = sl.begin(); it != sl.end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->first);
+		EXPECT_EQ(it->value, expected->second);
+	}
+	for (K key : keys) {
+		auto lower = sl.lower_bound(key);
+		auto referenceLower = reference.lower_bound(key);
+		if (referenceLower == reference.end()) {
+			EXPECT_EQ(lower, sl.end());
+		} else {
+			ASSERT_NE(lower, sl.end());
+			EXPECT_EQ(lower->key, referenceLower->first);
+		}
+	}
+}
+
+} // namespace
+
+TEST(SuccessorKeysTest, EncodingPreservesOrder) {
+	using Unsigned = skiplist::detail::SuccessorKey<std::uint32_t>;
+	EXPECT_LT(Unsigned::encode(0), Unsigned::encode(1));
+	EXPECT_LT(Unsigned::encode(0x7fffffffu), Unsigned::encode(0x80000000u));
+	EXPECT_EQ(Unsigned::encode(0xffffffffu), Unsigned::kNone);
+
+	using Signed = skiplist::detail::SuccessorKey<std::int64_t>;
+	EXPECT_LT(Signed::encode(-1), Signed::encode(0));
+	EXPECT_FALSE(skiplist::detail::SuccessorKey<std::int16_t>::kEnabled);
+	EXPECT_FALSE(skiplist::detail::SuccessorKey<bool>::kEnabled);
+}
+
+TEST(SuccessorKeysTest, KernelsAgree) {
+	expectKernelsAgree<std::int32_t>();
+	expectKernelsAgree<std::int64_t>();
+}
+
+TEST(SuccessorKeysTest, SkipListMatchesStdMap) {
+	expectMatchesStdMap<std::int64_t>();
+	expectMatchesStdMap<std::uint32_t>();
+	expectMatchesStdMap<std::uint64_t>();
+	expectMatchesStdMap<int>();
+}
+
+// bulkLoad 与 insertBatch 直接链接节点，同样要维护后继键
+TEST(SuccessorKeysTest, BulkLoadAndBatchKeepCacheConsistent) {
+	skiplist::SkipList<std::uint64_t, int> sl(16);
+	std::vector<std::pair<std::uint64_t, int>> sorted;
+	for (int i = 0; i < 1000; i++) {
+		sorted.emplace_back(static_cast<std::uint64_t>(i) * 3, i);
+	}
+	sl.bulkLoad(sorted.begin(), sorted.end());
+	sl.insertBatch({{1, 1}, {4, 4}, {std::numeric_limits<std::uint64_t>::max(), 0}});
+
+	for (std::uint64_t key = 0; key < 3000; key++) {
+		EXPECT_EQ(sl.contains(key), key % 3 == 0 || key == 1 || key == 4) << key;
+	}
+	EXPECT_TRUE(sl.contains(std::numeric_limits<std::uint64_t>::max()));
+}
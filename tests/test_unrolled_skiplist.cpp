@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "skiplist.hpp"
+#include "unrolled_skiplist.hpp"
+
+// 小块容量让少量元素就能触发分裂与合并
+using SmallBlockList = skiplist::UnrolledSkipList<int, std::string, std::less<int>,
+												  skiplist::NewDeleteAllocator, 16, 4>;
+
+TEST(UnrolledSkipListTest, InsertSearchRemove) {
+	SmallBlockList sl(16);
+	EXPECT_TRUE(sl.empty());
+	EXPECT_TRUE(sl.insert(5, "five"));
+	EXPECT_TRUE(sl.insert(10, "ten"));
+	EXPECT_TRUE(sl.insert(3, "three"));
+	EXPECT_FALSE(sl.insert(5, "five_duplicate"));
+
+	auto value = sl.search(5);
+	ASSERT_TRUE(value.has_value());
+	EXPECT_EQ(*value, "five");
+	EXPECT_FALSE(sl.search(7).has_value());
+	EXPECT_FALSE(sl.search(1).has_value());
+
+	EXPECT_TRUE(sl.remove(5));
+	EXPECT_FALSE(sl.remove(5));
+	EXPECT_FALSE(sl.contains(5));
+	EXPECT_TRUE(sl.contains(10));
+	EXPECT_TRUE(sl.contains(3));
+	EXPECT_EQ(sl.size(), 2);
+
+	EXPECT_FALSE(sl.insert_or_assign(3, "THREE"));
+	EXPECT_TRUE(sl.try_emplace(4, 3, 'x'));
+	EXPECT_EQ(*sl.search(3), "THREE");
+	EXPECT_EQ(*sl.search(4), "xxx");
+}
+
+// 随机的插入/删除与 std::map 对照，覆盖块的分裂、合并与整块释放
+TEST(UnrolledSkipListTest, MatchesStdMapUnderRandomChurn) {
+	SmallBlockList sl(16);
+	std::map<int, std::string> reference;
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<> dis(0, 999);
+
+	for (int round = 0; round < 20000; round++) {
+		int key = dis(gen);
+		if (gen() % 3 != 0) {
+			bool inserted = reference.emplace(key, std::to_string(key)).second;
+			EXPECT_EQ(sl.insert(key, std::to_string(key)), inserted);
+		} else {
+			EXPECT_EQ(sl.remove(key), reference.erase(key) == 1);
+		}
+	}
+
+	ASSERT_EQ(sl.size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (auto it = sl.begin(); it != sl.end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->first);
+		EXPECT_EQ(it->value, expected->second);
+	}
+	EXPECT_EQ(expected, reference.end());
+
+	// 合并保证块的平均填充率不低于 1/4
+	int blocks = sl.levelHistogram()[0];
+	EXPECT_LE(blocks, static_cast<int>(reference.size()) + 1);
+
+	for (auto& entry : reference) {
+		EXPECT_TRUE(sl.remove(entry.first));
+	}
+	EXPECT_TRUE(sl.empty());
+	EXPECT_EQ(sl.levelHistogram()[0], 0);
+	EXPECT_EQ(sl.begin(), sl.end());
+}
+
+TEST(UnrolledSkipListTest, BoundsAndScan) {
+	SmallBlockList sl(16);
+	for (int i = 0; i < 100; i += 2) {
+		sl.insert(i, std::to_string(i));
+	}
+
+	EXPECT_EQ(sl.lower_bound(10)->key, 10);
+	EXPECT_EQ(sl.lower_bound(11)->key, 12);
+	EXPECT_EQ(sl.upper_bound(10)->key, 12);
+	EXPECT_EQ(sl.lower_bound(-5)->key, 0);
+	EXPECT_EQ(sl.lower_bound(99), sl.end());
+	EXPECT_EQ(sl.upper_bound(98), sl.end());
+
+	std::vector<int> keys;
+	std::size_t visited = sl.scan(11, 21, [&keys](const int& key, const std::string& value) {
+		EXPECT_EQ(value, std::to_string(key));
+		keys.push_back(key);
+	});
+	EXPECT_EQ(visited, 5u);
+	EXPECT_EQ(keys, (std::vector<int>{12, 14, 16, 18, 20}));
+
+	keys.clear();
+	sl.scan(0, 100, [&keys](const int& key, const std::string&) {
+		keys.push_back(key);
+		return keys.size() < 3;
+	});
+	EXPECT_EQ(keys.size(), 3u);
+}
+
+TEST(UnrolledSkipListTest, BulkLoadAndBatch) {
+	SmallBlockList sl(16);
+	std::vector<std::pair<int, std::string>> sorted;
+	for (int i = 0; i < 1000; i++) {
+		sorted.emplace_back(i * 2, std::to_string(i * 2));
+	}
+	sorted.emplace_back(5, "out_of_order"); // 不满足严格递增，被跳过
+
+	EXPECT_EQ(sl.bulkLoad(sorted.begin(), sorted.end()), 1000u);
+	EXPECT_EQ(sl.size(), 1000);
+	EXPECT_EQ(sl.levelHistogram()[0], 250); // 每块装满 4 个
+	EXPECT_FALSE(sl.contains(5));
+	EXPECT_EQ(*sl.search(1998), "1998");
+
+	// 装满的块上继续插入会分裂
+	std::vector<std::pair<int, std::string>> batch = {{7, "7"}, {1, "1"}, {4, "dup"}, {1, "x"}};
+	EXPECT_EQ(sl.insertBatch(batch), 2u);
+	EXPECT_EQ(*sl.search(1), "1");
+	EXPECT_EQ(*sl.search(4), "4");
+
+	// 非空时 bulkLoad 在同一次加锁内排序合并，无序的输入也可以
+	std::vector<std::pair<int, std::string>> unsorted = {{9, "9"}, {3, "3"}, {2, "dup"}};
+	EXPECT_EQ(sl.bulkLoad(unsorted.begin(), unsorted.end()), 2u);
+	EXPECT_EQ(*sl.search(2), "2");
+	EXPECT_EQ(sl.size(), 1004);
+
+	int previous = -1;
+	for (auto it = sl.begin(); it != sl.end(); ++it) {
+		EXPECT_GT(it->key, previous);
+		previous = it->key;
+	}
+}
+
+TEST(UnrolledSkipListTest, FingerFollowsLocality) {
+	SmallBlockList sl(16);
+	SmallBlockList::Finger finger;
+	for (int i = 0; i < 2000; i++) {
+		EXPECT_TRUE(sl.insert(i, std::to_string(i), finger));
+	}
+	EXPECT_FALSE(sl.insert(10, "dup", finger));
+
+	// 逆序插入每次都落在 finger 之外并使块分裂，finger 应指向新键实际所在的块
+	SmallBlockList reversed(16);
+	SmallBlockList::Finger tail;
+	for (int i = 500; i > 0; i--) {
+		EXPECT_TRUE(reversed.insert(i, std::to_string(i), tail));
+		auto value = reversed.search(i, tail);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, std::to_string(i));
+	}
+
+	for (int i = 0; i < 2000; i++) {
+		auto value = sl.search(i, finger);
+		ASSERT_TRUE(value.has_value());
+		EXPECT_EQ(*value, std::to_string(i));
+	}
+
+	// 删除导致的合并使 finger 失效，之后的查找仍然正确
+	for (int i = 0; i < 2000; i += 3) {
+		sl.remove(i);
+	}
+	for (int i = 0; i < 2000; i++) {
+		EXPECT_EQ(sl.search(i, finger).has_value(), i % 3 != 0);
+	}
+}
+
+// 字符串键走块内二分查找，并支持透明比较器的异构查找
+TEST(UnrolledSkipListTest, StringKeysAndHeterogeneousLookup) {
+	skiplist::UnrolledSkipList<std::string, int, std::less<>> sl;
+	std::map<std::string, int> reference;
+	for (int i = 0; i < 3000; i++) {
+		std::string key = "key_" + std::to_string(i * 7919 % 3000);
+		sl.insert(key, i);
+		reference.emplace(key, i);
+	}
+
+	EXPECT_EQ(sl.size(), static_cast<int>(reference.size()));
+	auto expected = reference.begin();
+	for (auto it = sl.begin(); it != sl.end(); ++it, ++expected) {
+		EXPECT_EQ(it->key, expected->first);
+	}
+
+	std::string_view probe = "key_42";
+	EXPECT_TRUE(sl.contains(probe));
+	EXPECT_EQ(*sl.search(probe), reference["key_42"]);
+}
+
+TEST(UnrolledSkipListTest, ArenaAllocator) {
+	skiplist::UnrolledSkipList<int, std::string, std::less<int>, skiplist::ArenaAllocator> sl(16);
+	for (int i = 0; i < 5000; i++) {
+		sl.insert(i, "value_" + std::to_string(i));
+	}
+	for (int i = 0; i < 5000; i += 2) {
+		sl.remove(i);
+	}
+	EXPECT_EQ(sl.size(), 2500);
+	EXPECT_EQ(*sl.search(11), "value_11");
+	EXPECT_FALSE(sl.contains(10));
+}
+
+// 与 SkipList 使用同一种快照格式，可以互相加载
+TEST(UnrolledSkipListTest, SnapshotInteroperatesWithSkipList) {
+	std::string path = ::testing::TempDir() + "unrolled_snapshot.bin";
+	skiplist::SkipList<int, std::string> source(16);
+	for (int i = 0; i < 1000; i++) {
+		source.insert(i * 3, std::to_string(i));
+	}
+	ASSERT_TRUE(source.saveTo(path));
+
+	SmallBlockList unrolled(16);
+	ASSERT_TRUE(unrolled.loadFrom(path));
+	EXPECT_EQ(unrolled.size(), 1000);
+	EXPECT_EQ(unrolled.levelHistogram()[0], 250);
+	EXPECT_EQ(*unrolled.search(999), "333");
+
+	unrolled.remove(0);
+	ASSERT_TRUE(unrolled.saveTo(path));
+	skiplist::SkipList<int, std::string> back(16);
+	ASSERT_TRUE(back.loadFrom(path));
+	EXPECT_EQ(back.size(), 999);
+	EXPECT_FALSE(back.contains(0));
+	EXPECT_EQ(*back.search(3), "1");
+	std::remove(path.c_str());
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "durable_skiplist.hpp"
+#include "wal.hpp"
+
+namespace {
+
+// 每个测试使用独立的快照和日志文件，结束时删除
+class DurableSkipListTest : public ::testing::Test {
+protected:
+	std::string snapshot;
+	std::string log;
+
+	void SetUp() override {
+		std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+		snapshot = ::testing::TempDir() + "durable_" + name + ".snapshot";
+		log = ::testing::TempDir() + "durable_" + name + ".wal";
+		std::remove(snapshot.c_str());
+		std::remove(log.c_str());
+	}
+
+	void TearDown() override {
+		std::remove(snapshot.c_str());
+		std::remove(log.c_str());
+	}
+};
+
+using WalRecords = std::vector<std::pair<skiplist::WalOp, int>>;
+
+} // namespace
+
+TEST_F(DurableSkipListTest, RecoversFromLog) {
+	{
+		skiplist::DurableSkipList<int, std::string> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log));
+		EXPECT_TRUE(sl.insert(1, "one"));
+		EXPECT_TRUE(sl.insert(2, "two"));
+		EXPECT_FALSE(sl.insert(2, "dup")); // 没有改变跳表，不写日志
+		EXPECT_FALSE(sl.insert_or_assign(1, "ONE"));
+		EXPECT_TRUE(sl.remove(2));
+		EXPECT_FALSE(sl.remove(3));
+		EXPECT_TRUE(sl.insert(3, "three"));
+		EXPECT_TRUE(sl.healthy());
+	}
+
+	skiplist::DurableSkipList<int, std::string> restored(16);
+	ASSERT_TRUE(restored.open(snapshot, log));
+	EXPECT_EQ(restored.replayed(), 5u);
+	EXPECT_EQ(restored.size(), 2);
+	EXPECT_EQ(*restored.search(1), "ONE");
+	EXPECT_FALSE(restored.contains(2));
+	EXPECT_EQ(*restored.search(3), "three");
+}
+
+TEST_F(DurableSkipListTest, CheckpointTruncatesLog) {
+	{
+		skiplist::DurableSkipList<int, int> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log));
+		for (int i = 0; i < 1000; i++) {
+			sl.insert(i, i);
+		}
+		ASSERT_TRUE(sl.checkpoint());
+		EXPECT_EQ(std::filesystem::file_size(log), 0u);
+		// 快照已经 fsync 并改名到位，不留下临时文件
+		EXPECT_FALSE(std::filesystem::exists(snapshot + ".tmp"));
+
+		// 快照之后的修改继续写入日志
+		sl.remove(0);
+		sl.insert_or_assign(1, -1);
+	}
+
+	skiplist::DurableSkipList<int, int> restored(16);
+	ASSERT_TRUE(restored.open(snapshot, log));
+	EXPECT_EQ(restored.replayed(), 2u);
+	EXPECT_EQ(restored.size(), 999);
+	EXPECT_FALSE(restored.contains(0));
+	EXPECT_EQ(*restored.search(1), -1);
+	EXPECT_EQ(*restored.search(999), 999);
+}
+
+// 崩溃时写了一半的最后一条记录被丢弃，之后追加的记录仍然能重放
+TEST_F(DurableSkipListTest, DiscardsTornTail) {
+	{
+		skiplist::DurableSkipList<int, std::string> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log));
+		sl.insert(1, "one");
+		sl.insert(2, "two");
+	}
+	auto size = std::filesystem::file_size(log);
+	std::filesystem::resize_file(log, size - 2);
+	{
+		std::ofstream out(log, std::ios::binary | std::ios::app);
+		out << "xx";
+	}
+
+	{
+		skiplist::DurableSkipList<int, std::string> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log));
+		EXPECT_EQ(sl.replayed(), 1u);
+		EXPECT_TRUE(sl.contains(1));
+		EXPECT_FALSE(sl.contains(2));
+		sl.insert(3, "three");
+	}
+
+	skiplist::DurableSkipList<int, std::string> restored(16);
+	ASSERT_TRUE(restored.open(snapshot, log));
+	EXPECT_EQ(restored.replayed(), 2u);
+	EXPECT_EQ(*restored.search(3), "three");
+}
+
+TEST_F(DurableSkipListTest, ConcurrentWriters) {
+	constexpr int kThreads = 4;
+	constexpr int kPerThread = 200;
+	{
+		skiplist::DurableSkipList<int, int> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log, false));
+		std::vector<std::thread> threads;
+		for (int t = 0; t < kThreads; t++) {
+			threads.emplace_back([&sl, t] {
+				for (int i = 0; i < kPerThread; i++) {
+					int key = t * kPerThread + i;
+					sl.insert(key, key);
+					if (i % 2 == 0) {
+						sl.remove(key);
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	skiplist::DurableSkipList<int, int> restored(16);
+	ASSERT_TRUE(restored.open(snapshot, log));
+	EXPECT_EQ(restored.size(), kThreads * kPerThread / 2);
+	for (int key = 0; key < kThreads * kPerThread; key++) {
+		EXPECT_EQ(restored.contains(key), key % 2 == 1) << key;
+	}
+}
+
+// 写入与 checkpoint 并发时，恢复出的内容与关闭前内存中的内容一致
+TEST_F(DurableSkipListTest, CheckpointWithConcurrentWriters) {
+	constexpr int kThreads = 4;
+	constexpr int kKeys = 64;
+	std::vector<std::pair<int, int>> expected;
+	{
+		skiplist::DurableSkipList<int, int> sl(16);
+		ASSERT_TRUE(sl.open(snapshot, log, false));
+		std::vector<std::thread> threads;
+		for (int t = 0; t < kThreads; t++) {
+			threads.emplace_back([&sl, t] {
+				for (int i = 0; i < 500; i++) {
+					int key = (i * 7 + t) % kKeys;
+					if (i % 3 == 0) {
+						sl.remove(key);
+					} else {
+						sl.insert_or_assign(key, t * 1000 + i);
+					}
+				}
+			});
+		}
+		for (int i = 0; i < 10; i++) {
+			EXPECT_TRUE(sl.checkpoint());
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		sl.view().forEach([&expected](const int& key, const int& value) {
+			expected.emplace_back(key, value);
+		});
+	}
+
+	skiplist::DurableSkipList<int, int> restored(16);
+	ASSERT_TRUE(restored.open(snapshot, log));
+	std::vector<std::pair<int, int>> actual;
+	restored.view().forEach([&actual](const int& key, const int& value) {
+		actual.emplace_back(key, value);
+	});
+	EXPECT_EQ(actual, expected);
+}
+
+// 多条记录追加后一次 commit 只需要一次 fsync
+TEST_F(DurableSkipListTest, CommitCoversEarlierAppends) {
+	{
+		skiplist::WriteAheadLog<int, int> wal;
+		ASSERT_TRUE(wal.open(log, [](skiplist::WalOp, const int&, const int&) {}));
+		std::uint64_t sequence = 0;
+		for (int i = 0; i < 100; i++) {
+			sequence = i % 10 == 0 ? wal.appendRemove(i) : wal.appendPut(i, i);
+		}
+		EXPECT_TRUE(wal.commit(sequence));
+		EXPECT_EQ(wal.syncs(), 1u);
+		EXPECT_TRUE(wal.commit(sequence / 2)); // 已经落盘，不再写文件
+		EXPECT_EQ(wal.syncs(), 1u);
+	}
+
+	skiplist::WriteAheadLog<int, int> wal;
+	WalRecords records;
+	ASSERT_TRUE(wal.open(log, [&records](skiplist::WalOp op, const int& key, const int&) {
+		records.emplace_back(op, key);
+	}));
+	ASSERT_EQ(records.size(), 100u);
+	EXPECT_EQ(records[0], std::make_pair(skiplist::WalOp::Remove, 0));
+	EXPECT_EQ(records[99], std::make_pair(skiplist::WalOp::Put, 99));
+}
+
+// 日志写不进去（/dev/full 总是返回 ENOSPC）时修改报告失败，而不是假装已经落盘
+TEST_F(DurableSkipListTest, ReportsFailedCommit) {
+	if (!std::filesystem::exists("/dev/full")) {
+		GTEST_SKIP() << "需要 /dev/full";
+	}
+	skiplist::DurableSkipList<int, int> sl(16);
+	ASSERT_TRUE(sl.open(snapshot, "/dev/full", false));
+	EXPECT_FALSE(sl.insert(1, 1));
+	EXPECT_FALSE(sl.healthy());
+	EXPECT_FALSE(sl.contains(1)); // 没有落盘的修改不会作用到跳表
+
+	EXPECT_FALSE(sl.insert_or_assign(2, 2));
+	EXPECT_FALSE(sl.remove(1));
+	EXPECT_FALSE(sl.contains(2)); // 日志失败之后的修改全部被拒绝
+	EXPECT_TRUE(sl.empty());
+	EXPECT_FALSE(sl.checkpoint());
+}